@@ -80,6 +80,14 @@ void ChannelAccess::initialize(int stage)
     usePropagationDelay = par("usePropagationDelay");
 }
 
+void ChannelAccess::prepareForRecycling()
+{
+    BatteryAccess::prepareForRecycling();
+
+    findHost()->unsubscribe(BaseMobility::mobilityStateChangedSignal, this);
+    isRegistered = false;
+}
+
 void ChannelAccess::sendToChannel(cPacket* msg)
 {
     EV_TRACE << "sendToChannel: sending to gates\n";
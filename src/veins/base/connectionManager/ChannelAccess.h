@@ -125,6 +125,14 @@ public:
      **/
     void initialize(int stage) override;
 
+    /**
+     * @brief Stops following the host's position.
+     *
+     * The nic has to be unregistered from the ConnectionManager before (as TraCIScenarioManager does for all modules it removes).
+     * It is registered again on the first position update after initialize().
+     */
+    void prepareForRecycling() override;
+
     /**
      * @brief Called by the signalling mechanism to inform of changes.
      *
@@ -61,6 +61,14 @@ void BaseLayer::initialize(int stage)
     }
 }
 
+void BaseLayer::prepareForRecycling()
+{
+    BatteryAccess::prepareForRecycling();
+
+    delete passedMsg;
+    passedMsg = nullptr;
+}
+
 /**
  * The basic handle message function.
  *
@@ -88,6 +88,9 @@ public:
     /** @brief Initialization of the module and some variables*/
     void initialize(int) override;
 
+    /** @brief Deletes the message used for passed message statistics */
+    void prepareForRecycling() override;
+
     /** @brief Called every time a message arrives*/
     void handleMessage(cMessage*) override;
 
@@ -58,6 +58,11 @@ void BaseModule::initialize(int stage)
     }
 }
 
+void BaseModule::prepareForRecycling()
+{
+    findHost()->unsubscribe(catHostStateSignal, this);
+}
+
 void BaseModule::receiveSignal(cComponent* source, simsignal_t signalID, cObject* obj, cObject* details)
 {
     Enter_Method_Silent();
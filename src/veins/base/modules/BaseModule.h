@@ -120,6 +120,14 @@ public:
     /** @brief Basic initialization for all modules */
     void initialize(int) override;
 
+    /**
+     * @brief Undo what initialize() set up for the current host, so the module can be initialized again.
+     *
+     * Used by modules implementing RecyclableModule.
+     * Subclasses that set up more in initialize() should extend this method and call the one of their base class.
+     */
+    virtual void prepareForRecycling();
+
     /**
      * @brief Divide initialization into two stages
      *
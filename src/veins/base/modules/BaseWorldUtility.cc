@@ -26,6 +26,7 @@
 
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/utils/FindModule.h"
+#include "veins/base/utils/ObjectPool.h"
 #include "veins/base/connectionManager/BaseConnectionManager.h"
 
 using namespace veins;
@@ -34,6 +35,7 @@ Define_Module(veins::BaseWorldUtility);
 
 BaseWorldUtility::BaseWorldUtility()
     : isInitialized(false)
+    , recordPoolStatistics(false)
 {
 }
 
@@ -41,6 +43,11 @@ void BaseWorldUtility::initialize(int stage)
 {
     if (stage == 0) {
         initializeIfNecessary();
+        recordPoolStatistics = par("recordPoolStatistics");
+        // pools live as long as the process, which may run several simulations (e.g., Cmdenv with -r 0..N)
+        for (auto pool : ObjectPool::getPools()) {
+            pool->resetStatistics();
+        }
     }
     else if (stage == 1) {
         // check if necessary modules are there
@@ -51,6 +58,18 @@ void BaseWorldUtility::initialize(int stage)
     }
 }
 
+void BaseWorldUtility::finish()
+{
+    if (!recordPoolStatistics) return;
+
+    // pools are shared by all modules of the simulation, so they are only recorded here
+    for (auto pool : ObjectPool::getPools()) {
+        recordScalar((pool->getName() + " poolAllocations").c_str(), pool->getNumAllocations());
+        recordScalar((pool->getName() + " poolHits").c_str(), pool->getNumHits());
+        recordScalar((pool->getName() + " poolHitRate").c_str(), pool->getHitRate());
+    }
+}
+
 void BaseWorldUtility::initializeIfNecessary()
 {
     if (isInitialized) return;
@@ -60,6 +60,9 @@ protected:
     /** @brief Stores if members are already initialized. */
     bool isInitialized;
 
+    /** @brief Record statistics of all ObjectPools at the end of the run? */
+    bool recordPoolStatistics;
+
 public:
     /** @brief Speed of light in meters per second. */
     static const double speedOfLight()
@@ -80,6 +83,7 @@ public:
     BaseWorldUtility();
 
     void initialize(int stage) override;
+    void finish() override;
 
     /**
      * @brief Returns the playgroundSize
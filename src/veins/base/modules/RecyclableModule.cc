@@ -0,0 +1,66 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/base/modules/RecyclableModule.h"
+
+#include <algorithm>
+
+using namespace veins;
+
+namespace {
+
+template <typename F>
+void callInContext(RecyclableModule* module, F f)
+{
+    // modules are usually simple modules, but need not be (e.g., in tests)
+    if (cComponent* component = dynamic_cast<cComponent*>(module)) {
+        cContextSwitcher tmp(component);
+        f();
+    }
+    else {
+        f();
+    }
+}
+
+} // namespace
+
+void RecyclableModule::prepareAll(const std::vector<RecyclableModule*>& modules)
+{
+    for (auto module : modules) {
+        callInContext(module, [module]() { module->prepareForRecycling(); });
+    }
+}
+
+void RecyclableModule::reinitializeAll(const std::vector<RecyclableModule*>& modules)
+{
+    int numStages = 0;
+    for (auto module : modules) {
+        numStages = std::max(numStages, module->numReinitStages());
+    }
+    for (int stage = 0; stage < numStages; stage++) {
+        for (auto module : modules) {
+            if (stage >= module->numReinitStages()) continue;
+            callInContext(module, [module, stage]() { module->reinitialize(stage); });
+        }
+    }
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Interface for modules that can be re-used for a new vehicle after the vehicle they were created for has left the simulation.
+ *
+ * If TraCIScenarioManager is configured to recycle vehicle modules (see its recycleVehicleModules parameter),
+ * vehicle modules whose simple modules all implement this interface are not deleted when their vehicle leaves the simulation,
+ * but kept and re-initialized for the next vehicle of the same module type. The reset protocol is:
+ *
+ *  - prepareForRecycling() is called for all modules (parents before submodules), instead of finish()
+ *  - any messages still on their way to the parked modules are deleted
+ *  - once the module is re-used, preInitializeModule() is called, as for a new module
+ *  - reinitialize(stage) is called for all modules, one stage at a time, instead of initialize(stage)
+ *  - finish() is only called once, when the module is deleted at the end of the simulation
+ *
+ * A recycled module thus records its results once, accumulated over all vehicles it was used for.
+ * Modules must keep their statistics across prepareForRecycling() and reinitialize(stage) for this.
+ *
+ * BaseModule and its subclasses provide prepareForRecycling() for the state they set up in initialize(stage).
+ * Each class in a hierarchy implementing this interface should call the method of its base class, so every layer can reset its own state.
+ * Subclasses of a recyclable module that add state of their own (e.g., self messages or signal subscriptions) must extend prepareForRecycling().
+ *
+ * @see TraCIScenarioManager
+ */
+class VEINS_API RecyclableModule {
+public:
+    virtual ~RecyclableModule() = default;
+
+    /**
+     * Prepare for being re-used for another vehicle: cancel (and delete) all self messages, unsubscribe from all signals, and release all resources belonging to the current vehicle.
+     * Called instead of finish().
+     */
+    virtual void prepareForRecycling() = 0;
+
+    /**
+     * Re-initialize the module for a new vehicle, like initialize(stage) does for a new module.
+     * Must reset all state that initialize(stage) would not, except for statistics.
+     */
+    virtual void reinitialize(int stage) = 0;
+
+    /**
+     * Returns the number of stages reinitialize needs, usually numInitStages().
+     */
+    virtual int numReinitStages() const = 0;
+
+    /**
+     * Calls prepareForRecycling() for all modules, in the given order, each in the context of the respective module.
+     */
+    static void prepareAll(const std::vector<RecyclableModule*>& modules);
+
+    /**
+     * Calls reinitialize(stage) for all modules, one stage at a time, each in the context of the respective module.
+     */
+    static void reinitializeAll(const std::vector<RecyclableModule*>& modules);
+};
+
+} // namespace veins
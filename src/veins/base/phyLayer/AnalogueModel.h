@@ -77,6 +77,25 @@ public:
     {
         return false;
     }
+
+    /**
+     * If the model wants to be told about all receivers of a transmission before it is sent (see prepareTransmission), it returns true here.
+     */
+    virtual bool needsTransmissionPreparation() const
+    {
+        return false;
+    }
+
+    /**
+     * Called by the sender's physical layer before a transmission is sent to all receivers in range.
+     *
+     * This allows computing per-receiver results for all receivers at once (e.g., in parallel), which filterSignal can then look up.
+     *
+     * @param links the positions of the sender's and the receiver's antenna at the time the receiver starts receiving, for each receiver
+     */
+    virtual void prepareTransmission(const std::vector<std::pair<Coord, Coord>>& /* links */)
+    {
+    }
 };
 
 using AnalogueModelList = std::vector<std::unique_ptr<AnalogueModel>>;
@@ -22,6 +22,8 @@
 
 #include "veins/base/phyLayer/Antenna.h"
 
+#include <typeinfo>
+
 using namespace veins;
 
 double Antenna::getGain(Coord ownPos, Coord ownOrient, Coord otherPos)
@@ -29,3 +31,8 @@ double Antenna::getGain(Coord ownPos, Coord ownOrient, Coord otherPos)
     // as this base class represents an isotropic antenna, simply return 1.0
     return 1.0;
 }
+
+bool Antenna::isIsotropic() const
+{
+    return typeid(*this) == typeid(Antenna);
+}
@@ -62,6 +62,14 @@ public:
      */
     virtual double getGain(Coord ownPos, Coord ownOrient, Coord otherPos);
 
+    /**
+     * Returns whether this antenna has the same gain in all directions.
+     *
+     * If both antennas of a link are isotropic, computing the gain can be skipped altogether.
+     * Only instances of this base class are considered isotropic, subclasses are not (unless they override this method).
+     */
+    virtual bool isIsotropic() const;
+
     virtual double getLastAngle()
     {
         return -1.0;
@@ -24,6 +24,7 @@
 
 #include "veins/base/phyLayer/BasePhyLayer.h"
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -102,6 +103,15 @@ void BasePhyLayer::initialize(int stage)
             throw cRuntimeError("minPowerLevel can't be smaller than the signal attenuation threshold (sat) in ConnectionManager. Please adjust your omnetpp.ini file accordingly.");
         }
 
+        if (par("batchAnalogueModelRandomVariates").boolValue()) {
+            int rng = par("analogueModelRng").intValue();
+            // module-local RNGs without a mapping (rng-k in the ini file) use the global RNG of the same index
+            if (rng < 0 || (rng >= getNumRNGs() && rng >= getEnvir()->getNumRNGs())) {
+                throw cRuntimeError("analogueModelRng is %d, but only %d RNGs are configured: set num-rngs to at least %d, map the RNG in the ini file (e.g., **.phy80211p.rng-%d = 0), or set analogueModelRng to 0", rng, getEnvir()->getNumRNGs(), rng + 1, rng);
+            }
+            analogueModelRandom = make_unique<BatchedRandom>(getRNG(rng), par("analogueModelRandomBatchSize").intValue());
+        }
+
         initializeAnalogueModels(par("analogueModels").xmlValue());
         initializeDecider(par("decider").xmlValue());
         initializeAntenna(par("antenna").xmlValue());
@@ -319,7 +329,14 @@ std::shared_ptr<Antenna> BasePhyLayer::initializeSampledAntenna1D(ParameterMap&
         std::copy(std::istream_iterator<double>(rotationStream), std::istream_iterator<double>(), std::back_inserter(rotationParams));
     }
 
-    return std::make_shared<SampledAntenna1D>(values, offsetType, offsetParams, rotationType, rotationParams, this->getRNG(0));
+    // get optional resolution (in degrees) of a precomputed gain table
+    double tableResolution = 0;
+    it = params.find("gain-table-resolution");
+    if (it != params.end()) {
+        tableResolution = it->second.doubleValue();
+    }
+
+    return std::make_shared<SampledAntenna1D>(values, offsetType, offsetParams, rotationType, rotationParams, this->getRNG(0), tableResolution);
 }
 
 // -----AnalogueModels initialization----------------
@@ -629,10 +646,30 @@ void BasePhyLayer::sendMacPktUp(cMessage* pkt)
 
 void BasePhyLayer::sendMessageDown(AirFrame* msg)
 {
-
+    prepareAnalogueModels();
     sendToChannel(msg);
 }
 
+void BasePhyLayer::prepareAnalogueModels()
+{
+    auto needsPreparation = [](const std::unique_ptr<AnalogueModel>& model) { return model->needsTransmissionPreparation(); };
+    bool anyModelNeedsPreparation = std::any_of(analogueModels.begin(), analogueModels.end(), needsPreparation) || std::any_of(analogueModelsThresholding.begin(), analogueModelsThresholding.end(), needsPreparation);
+    if (!anyModelNeedsPreparation) return;
+
+    // positions are taken at the time each receiver will start receiving, just like BasePhyLayer::filterSignal will do on the receiving side
+    transmissionLinks.clear();
+    for (auto&& entry : cc->getGateList(getParentModule()->getId())) {
+        const simtime_t receptionStart = simTime() + calculatePropagationDelay(entry.first);
+        transmissionLinks.emplace_back(antennaPosition.getPositionAt(receptionStart), entry.first->chAccess->getAntennaPosition().getPositionAt(receptionStart));
+    }
+
+    for (auto* models : {&analogueModels, &analogueModelsThresholding}) {
+        for (auto& model : *models) {
+            if (model->needsTransmissionPreparation()) model->prepareTransmission(transmissionLinks);
+        }
+    }
+}
+
 void BasePhyLayer::sendSelfMessage(cMessage* msg, simtime_t_cref time)
 {
     // TODO: maybe delete this method because it doesn't makes much sense,
@@ -648,25 +685,29 @@ void BasePhyLayer::filterSignal(AirFrame* frame)
     Signal& signal = frame->getSignal();
 
     // Extract position and orientation of sender and receiver (this module) first
-    const AntennaPosition receiverPosition = antennaPosition;
+    const AntennaPosition& receiverPosition = antennaPosition;
     const Coord receiverOrientation = antennaHeading.toCoord();
     // get POA from frame with the sender's position, orientation and antenna
     POA& senderPOA = frame->getPoa();
-    const AntennaPosition senderPosition = senderPOA.pos;
-    const Coord senderOrientation = senderPOA.orientation;
+    const AntennaPosition& senderPosition = senderPOA.pos;
+    const Coord& senderOrientation = senderPOA.orientation;
 
     // add position information to signal
     signal.setSenderPoa(senderPOA);
     signal.setReceiverPoa({receiverPosition, receiverOrientation, antenna});
 
-    // compute gains at sender and receiver antenna
-    double receiverGain = antenna->getGain(receiverPosition.getPositionAt(), receiverOrientation, senderPosition.getPositionAt());
-    double senderGain = senderPOA.antenna->getGain(senderPosition.getPositionAt(), senderOrientation, receiverPosition.getPositionAt());
+    // compute gains at sender and receiver antenna (unless both are isotropic, i.e., have a gain of 1 in every direction)
+    if (!antenna->isIsotropic() || !senderPOA.antenna->isIsotropic()) {
+        const Coord senderPos = senderPosition.getPositionAt();
+        const Coord receiverPos = receiverPosition.getPositionAt();
+        double receiverGain = antenna->getGain(receiverPos, receiverOrientation, senderPos);
+        double senderGain = senderPOA.antenna->getGain(senderPos, senderOrientation, receiverPos);
 
-    // add the resulting total gain to the attenuations list
-    EV_TRACE << "Sender's antenna gain: " << senderGain << endl;
-    EV_TRACE << "Own (receiver's) antenna gain: " << receiverGain << endl;
-    signal *= receiverGain * senderGain;
+        // add the resulting total gain to the attenuations list
+        EV_TRACE << "Sender's antenna gain: " << senderGain << endl;
+        EV_TRACE << "Own (receiver's) antenna gain: " << receiverGain << endl;
+        signal *= receiverGain * senderGain;
+    }
 
     // go on with AnalogueModels
     // attach analogue models suitable for thresholding to signal (for later evaluation)
@@ -703,6 +744,28 @@ BasePhyLayer::~BasePhyLayer()
     }
 }
 
+void BasePhyLayer::prepareForRecycling()
+{
+    ChannelAccess::prepareForRecycling();
+
+    // see ~BasePhyLayer
+    AirFrameVector channel;
+    channelInfo.getAirFrames(0, simTime(), channel);
+    for (auto frame : channel) {
+        cancelAndDelete(frame);
+    }
+    channelInfo = ChannelInfo();
+
+    cancelAndDelete(txOverTimer);
+    txOverTimer = nullptr;
+    cancelAndDelete(radioSwitchingOverTimer);
+    radioSwitchingOverTimer = nullptr;
+
+    // re-created by initialize
+    analogueModels.clear();
+    analogueModelsThresholding.clear();
+}
+
 // --MacToPhyInterface implementation-----------------------
 
 int BasePhyLayer::getRadioState()
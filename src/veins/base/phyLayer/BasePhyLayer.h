@@ -36,6 +36,7 @@
 #include "veins/base/phyLayer/MacToPhyInterface.h"
 #include "veins/base/phyLayer/Antenna.h"
 #include "veins/base/phyLayer/ChannelInfo.h"
+#include "veins/base/utils/BatchedRandom.h"
 
 namespace veins {
 
@@ -142,6 +143,16 @@ protected:
      */
     AnalogueModelList analogueModelsThresholding;
 
+    /** @brief Sender and receiver antenna positions of the transmission currently being sent (see prepareAnalogueModels) */
+    std::vector<std::pair<Coord, Coord>> transmissionLinks;
+
+    /**
+     * Batched random variates for analogue models, drawn from a dedicated RNG of this module.
+     *
+     * Only present if enabled by the batchAnalogueModelRandomVariates parameter.
+     */
+    std::unique_ptr<BatchedRandom> analogueModelRandom;
+
     int upperLayerIn; ///< The id of the in-data gate from the Mac layer.
     int upperLayerOut; ///< The id of the out-data gate to the Mac layer.
     int upperControlOut; ///< The id of the out-control gate to the Mac layer.
@@ -303,6 +314,11 @@ protected:
      */
     void sendMessageDown(AirFrame* pkt);
 
+    /**
+     * Tell analogue models that need it (see AnalogueModel::prepareTransmission) about all receivers of a transmission that is about to be sent
+     */
+    void prepareAnalogueModels();
+
     /**
      * Schedule self message to passed point in time.
      */
@@ -383,6 +399,12 @@ public:
     /** Call the deciders finish method. */
     void finish() override;
 
+    /**
+     * Delete all AirFrames on the channel, all timers, and the analogue models.
+     * The decider is only replaced by initialize(), so it can still record its statistics in finish().
+     */
+    void prepareForRecycling() override;
+
     // ---------MacToPhyInterface implementation-----------
     /**
      * @name MacToPhyInterface implementation
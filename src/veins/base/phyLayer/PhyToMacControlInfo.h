@@ -28,6 +28,7 @@
 
 #include "veins/base/phyLayer/Decider.h"
 #include "veins/base/utils/SimpleAddress.h"
+#include "veins/base/utils/ObjectPool.h"
 
 namespace veins {
 
@@ -39,7 +40,7 @@ namespace veins {
  * @ingroup phyLayer
  * @ingroup macLayer
  */
-class VEINS_API PhyToMacControlInfo : public cObject {
+class VEINS_API PhyToMacControlInfo : public cObject, public Pooled<PhyToMacControlInfo> {
 protected:
     /** The result of the decider evaluation.*/
     DeciderResult* result;
@@ -244,12 +244,12 @@ void Signal::applyAllAnalogueModels()
     }
 }
 
-POA Signal::getSenderPoa() const
+const POA& Signal::getSenderPoa() const
 {
     return senderPoa;
 }
 
-POA Signal::getReceiverPoa() const
+const POA& Signal::getReceiverPoa() const
 {
     return receiverPoa;
 }
@@ -259,11 +259,21 @@ void Signal::setSenderPoa(const POA& poa)
     senderPoa = poa;
 }
 
+void Signal::setSenderPoa(POA&& poa)
+{
+    senderPoa = std::move(poa);
+}
+
 void Signal::setReceiverPoa(const POA& poa)
 {
     receiverPoa = poa;
 }
 
+void Signal::setReceiverPoa(POA&& poa)
+{
+    receiverPoa = std::move(poa);
+}
+
 simtime_t_cref Signal::getSendingStart() const
 {
     return sendingStart;
@@ -411,6 +421,12 @@ Signal operator+(const Signal& lhs, const Signal& rhs)
     return result;
 }
 
+Signal operator+(Signal&& lhs, const Signal& rhs)
+{
+    lhs += rhs;
+    return std::move(lhs);
+}
+
 Signal operator+(const Signal& lhs, double rhs)
 {
     Signal result(lhs);
@@ -418,6 +434,12 @@ Signal operator+(const Signal& lhs, double rhs)
     return result;
 }
 
+Signal operator+(Signal&& lhs, double rhs)
+{
+    lhs += rhs;
+    return std::move(lhs);
+}
+
 Signal operator+(double lhs, const Signal& rhs)
 {
     Signal result(rhs);
@@ -425,6 +447,12 @@ Signal operator+(double lhs, const Signal& rhs)
     return result;
 }
 
+Signal operator+(double lhs, Signal&& rhs)
+{
+    rhs += lhs;
+    return std::move(rhs);
+}
+
 Signal operator-(const Signal& lhs, const Signal& rhs)
 {
     Signal result(lhs);
@@ -432,6 +460,12 @@ Signal operator-(const Signal& lhs, const Signal& rhs)
     return result;
 }
 
+Signal operator-(Signal&& lhs, const Signal& rhs)
+{
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
 Signal operator-(const Signal& lhs, double rhs)
 {
     Signal result(lhs);
@@ -439,6 +473,12 @@ Signal operator-(const Signal& lhs, double rhs)
     return result;
 }
 
+Signal operator-(Signal&& lhs, double rhs)
+{
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
 Signal operator-(double lhs, const Signal& rhs)
 {
     return lhs + (-1 * rhs);
@@ -451,6 +491,12 @@ Signal operator*(const Signal& lhs, const Signal& rhs)
     return result;
 }
 
+Signal operator*(Signal&& lhs, const Signal& rhs)
+{
+    lhs *= rhs;
+    return std::move(lhs);
+}
+
 Signal operator*(const Signal& lhs, double rhs)
 {
     Signal result(lhs);
@@ -458,6 +504,12 @@ Signal operator*(const Signal& lhs, double rhs)
     return result;
 }
 
+Signal operator*(Signal&& lhs, double rhs)
+{
+    lhs *= rhs;
+    return std::move(lhs);
+}
+
 Signal operator*(double lhs, const Signal& rhs)
 {
     Signal result(rhs);
@@ -465,6 +517,12 @@ Signal operator*(double lhs, const Signal& rhs)
     return result;
 }
 
+Signal operator*(double lhs, Signal&& rhs)
+{
+    rhs *= lhs;
+    return std::move(rhs);
+}
+
 Signal operator/(const Signal& lhs, const Signal& rhs)
 {
     Signal result(lhs);
@@ -472,6 +530,12 @@ Signal operator/(const Signal& lhs, const Signal& rhs)
     return result;
 }
 
+Signal operator/(Signal&& lhs, const Signal& rhs)
+{
+    lhs /= rhs;
+    return std::move(lhs);
+}
+
 Signal operator/(const Signal& lhs, double rhs)
 {
     Signal result(lhs);
@@ -479,12 +543,18 @@ Signal operator/(const Signal& lhs, double rhs)
     return result;
 }
 
+Signal operator/(Signal&& lhs, double rhs)
+{
+    lhs /= rhs;
+    return std::move(lhs);
+}
+
 Signal operator/(double lhs, const Signal& rhs)
 {
     // Create constant signal
     Signal sigLhs(rhs.getSpectrum());
     sigLhs = lhs;
-    return sigLhs / rhs;
+    return std::move(sigLhs) / rhs;
 }
 
 std::ostream& operator<<(std::ostream& os, const Signal& s)
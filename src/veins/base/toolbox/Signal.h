@@ -26,6 +26,7 @@
 
 #include "veins/base/utils/POA.h"
 #include "veins/base/utils/Coord.h"
+#include "veins/base/utils/SmallVector.h"
 #include "veins/base/toolbox/Spectrum.h"
 #include "veins/base/phyLayer/AnalogueModel.h"
 
@@ -38,11 +39,19 @@ namespace veins {
  * The signal power is stored in milliwatt.
  * Signals can be combined arithmetically to, e.g., compute interference introduced by several overlapping signals.
  *
+ * Power values of up to maxInlineValues frequencies are stored inside the Signal itself, which covers the spectrum of all 802.11p channels.
+ * Signals on such spectra are copied without any heap allocation; longer ones are moved without copying their values.
+ *
  * @see SignalUtils
  * @see Spectrum
  */
 class VEINS_API Signal {
 public:
+    /**
+     * Maximum number of power values stored without heap allocation.
+     */
+    static const size_t maxInlineValues = 16;
+
     Signal() = default;
 
     /**
@@ -50,6 +59,11 @@ public:
      */
     Signal(const Signal& other);
 
+    /**
+     * Move another Signal, leaving it without power values.
+     */
+    Signal(Signal&& other) = default;
+
     /**
      * Create a Signal with zero power and without timing information.
      */
@@ -295,12 +309,12 @@ public:
     /**
      * Get this signal's sender POA.
      */
-    POA getSenderPoa() const;
+    const POA& getSenderPoa() const;
 
     /**
      * Get this signal's receiver POA.
      */
-    POA getReceiverPoa() const;
+    const POA& getReceiverPoa() const;
 
     /**
      * Set this signal's sender POA.
@@ -309,12 +323,26 @@ public:
      */
     void setSenderPoa(const POA& poa);
 
+    /**
+     * Set this signal's sender POA.
+     *
+     * @param poa the new sender POA
+     */
+    void setSenderPoa(POA&& poa);
+
     /**
      * Set this signal's receiver POA.
      *
      * @param poa the new receiver POA
      */
     void setReceiverPoa(const POA& poa);
+
+    /**
+     * Set this signal's receiver POA.
+     *
+     * @param poa the new receiver POA
+     */
+    void setReceiverPoa(POA&& poa);
     ///@}
 
     /**
@@ -404,6 +432,13 @@ public:
      */
     Signal& operator=(const Signal& other);
 
+    /**
+     * Move another signal into this one.
+     *
+     * @param other the other signal
+     */
+    Signal& operator=(Signal&& other) = default;
+
     /**
      * @name Arithmetic operators
      */
@@ -495,7 +530,7 @@ private:
 
     Spectrum spectrum;
 
-    std::vector<double> values;
+    SmallVector<double, maxInlineValues> values;
 
     size_t numDataValues = 0;
     size_t dataOffset = 0;
@@ -531,6 +566,14 @@ private:
  */
 Signal VEINS_API operator+(const Signal& lhs, const Signal& rhs);
 
+/**
+ * Add two signals to each other, reusing the storage of the first one.
+ *
+ * @param lhs the first signal
+ * @param rhs the second signal
+ */
+Signal VEINS_API operator+(Signal&& lhs, const Signal& rhs);
+
 /**
  * Increment a signal's power levels by a constant.
  *
@@ -539,6 +582,14 @@ Signal VEINS_API operator+(const Signal& lhs, const Signal& rhs);
  */
 Signal VEINS_API operator+(const Signal& lhs, double rhs);
 
+/**
+ * Increment a signal's power levels by a constant, reusing its storage.
+ *
+ * @param lhs the signal to add
+ * @param rhs power level to add in milliwatt
+ */
+Signal VEINS_API operator+(Signal&& lhs, double rhs);
+
 /**
  * Increment a signal's power levels by a constant.
  *
@@ -547,6 +598,14 @@ Signal VEINS_API operator+(const Signal& lhs, double rhs);
  */
 Signal VEINS_API operator+(double lhs, const Signal& rhs);
 
+/**
+ * Increment a signal's power levels by a constant, reusing its storage.
+ *
+ * @param lhs power level to add in milliwatt
+ * @param rhs the signal to add
+ */
+Signal VEINS_API operator+(double lhs, Signal&& rhs);
+
 /**
  * Substract two signals from each other.
  *
@@ -557,6 +616,14 @@ Signal VEINS_API operator+(double lhs, const Signal& rhs);
  */
 Signal VEINS_API operator-(const Signal& lhs, const Signal& rhs);
 
+/**
+ * Substract two signals from each other, reusing the storage of the first one.
+ *
+ * @param lhs the first signal
+ * @param rhs the second signal
+ */
+Signal VEINS_API operator-(Signal&& lhs, const Signal& rhs);
+
 /**
  * Decrement a signal's power levels by a constant.
  *
@@ -565,6 +632,14 @@ Signal VEINS_API operator-(const Signal& lhs, const Signal& rhs);
  */
 Signal VEINS_API operator-(const Signal& lhs, double rhs);
 
+/**
+ * Decrement a signal's power levels by a constant, reusing its storage.
+ *
+ * @param lhs the signal to substract from
+ * @param rhs power level to substract in milliwatt
+ */
+Signal VEINS_API operator-(Signal&& lhs, double rhs);
+
 /**
  * Decrement a constant power level by a signal's power levels.
  *
@@ -583,6 +658,14 @@ Signal VEINS_API operator-(double lhs, const Signal& rhs);
  */
 Signal VEINS_API operator*(const Signal& lhs, const Signal& rhs);
 
+/**
+ * Multiply two signals by each other, reusing the storage of the first one.
+ *
+ * @param lhs the first signal
+ * @param rhs the second signal
+ */
+Signal VEINS_API operator*(Signal&& lhs, const Signal& rhs);
+
 /**
  * Multiply a signal's power levels by a constant.
  *
@@ -591,6 +674,14 @@ Signal VEINS_API operator*(const Signal& lhs, const Signal& rhs);
  */
 Signal VEINS_API operator*(const Signal& lhs, double rhs);
 
+/**
+ * Multiply a signal's power levels by a constant, reusing its storage.
+ *
+ * @param lhs the signal to multiply with
+ * @param rhs power level to multiply by in milliwatt
+ */
+Signal VEINS_API operator*(Signal&& lhs, double rhs);
+
 /**
  * Multiply a signal's power levels by a constant.
  *
@@ -599,6 +690,14 @@ Signal VEINS_API operator*(const Signal& lhs, double rhs);
  */
 Signal VEINS_API operator*(double lhs, const Signal& rhs);
 
+/**
+ * Multiply a signal's power levels by a constant, reusing its storage.
+ *
+ * @param lhs power level to multiply by in milliwatt
+ * @param rhs the signal to multiply with
+ */
+Signal VEINS_API operator*(double lhs, Signal&& rhs);
+
 /**
  * Divide two signals by each other.
  *
@@ -609,6 +708,14 @@ Signal VEINS_API operator*(double lhs, const Signal& rhs);
  */
 Signal VEINS_API operator/(const Signal& lhs, const Signal& rhs);
 
+/**
+ * Divide two signals by each other, reusing the storage of the first one.
+ *
+ * @param lhs the first signal (dividend)
+ * @param rhs the second signal (divisor)
+ */
+Signal VEINS_API operator/(Signal&& lhs, const Signal& rhs);
+
 /**
  * Divide a signal's power levels by a constant.
  *
@@ -617,6 +724,14 @@ Signal VEINS_API operator/(const Signal& lhs, const Signal& rhs);
  */
 Signal VEINS_API operator/(const Signal& lhs, double rhs);
 
+/**
+ * Divide a signal's power levels by a constant, reusing its storage.
+ *
+ * @param lhs the dividend
+ * @param rhs the constnat divisor in milliwatt
+ */
+Signal VEINS_API operator/(Signal&& lhs, double rhs);
+
 /**
  * Divide a a constant by a signal's power levels.
  *
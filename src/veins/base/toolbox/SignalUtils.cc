@@ -149,7 +149,7 @@ double VEINS_API getMinSINR(simtime_t start, simtime_t end, AirFrame* signalFram
     Spectrum spectrum = signal.getSpectrum();
 
     Signal interference = getMaxInterference(start, end, signalFrame, interfererFrames);
-    Signal sinr = signal / (interference + noise);
+    Signal sinr = signal / (std::move(interference) + noise);
 
     double min_sinr = INFINITY;
     for (uint16_t i = signal.getDataStart(); i < signal.getDataEnd(); i++) {
@@ -22,6 +22,7 @@
 
 #include "veins/base/toolbox/Spectrum.h"
 
+#include <set>
 #include <sstream>
 
 namespace veins {
@@ -34,39 +35,53 @@ Spectrum::Frequencies normalizeFrequencies(Spectrum::Frequencies freqs)
     return freqs;
 }
 
+const Spectrum::Frequencies* internFrequencies(Spectrum::Frequencies freqs)
+{
+    // elements of a std::set never move, so pointers to them stay valid for the whole run
+    static std::set<Spectrum::Frequencies> knownFrequencies;
+    return &*knownFrequencies.insert(std::move(freqs)).first;
+}
+
+Spectrum::Spectrum()
+{
+    static const Frequencies* noFrequencies = internFrequencies({});
+    frequencies = noFrequencies;
+}
+
 Spectrum::Spectrum(Spectrum::Frequencies freqs)
-    : frequencies(normalizeFrequencies(freqs))
+    : frequencies(internFrequencies(normalizeFrequencies(freqs)))
 {
 }
 
 const double& Spectrum::operator[](size_t index) const
 {
-    return frequencies.at(index);
+    return frequencies->at(index);
 }
 
 size_t Spectrum::indexOf(double freq) const
 {
     // Binary search
-    auto it = std::lower_bound(frequencies.begin(), frequencies.end(), freq);
-    bool found = it != frequencies.end() && (*it) == freq;
+    auto it = std::lower_bound(frequencies->begin(), frequencies->end(), freq);
+    bool found = it != frequencies->end() && (*it) == freq;
 
     ASSERT(found == true);
 
-    return std::distance(frequencies.begin(), it);
+    return std::distance(frequencies->begin(), it);
 }
 
 double Spectrum::freqAt(size_t freqIndex) const
 {
-    return frequencies.at(freqIndex);
+    return frequencies->at(freqIndex);
 }
 
 size_t Spectrum::getNumFreqs() const
 {
-    return frequencies.size();
+    return frequencies->size();
 }
 
 bool operator==(const Spectrum& lhs, const Spectrum& rhs)
 {
+    // frequency lists are interned, so equal lists are the same object
     return lhs.frequencies == rhs.frequencies;
 }
 
@@ -74,7 +89,7 @@ std::ostream& operator<<(std::ostream& os, const Spectrum& s)
 {
     os << "Spectrum(";
     std::ostringstream ss;
-    for (auto&& frequency : s.frequencies) {
+    for (auto&& frequency : *s.frequencies) {
         if (ss.tellp() != 0) {
             ss << ", ";
         }
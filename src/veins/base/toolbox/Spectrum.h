@@ -35,12 +35,18 @@
 
 namespace veins {
 
+/**
+ * A sorted set of frequencies on which Signals are defined.
+ *
+ * The frequency lists of all Spectrum objects are interned, i.e., every distinct list is stored only once for the whole run.
+ * Copying a Spectrum therefore never copies frequencies and comparing two Spectrum objects is a pointer comparison.
+ */
 class VEINS_API Spectrum {
 public:
     using Frequency = double;
     using Frequencies = std::vector<Frequency>;
 
-    Spectrum() = default;
+    Spectrum();
     Spectrum(Frequencies freqs);
 
     const double& operator[](size_t index) const;
@@ -56,7 +62,7 @@ public:
     friend std::ostream& VEINS_API operator<<(std::ostream& os, const Spectrum& s);
 
 private:
-    Frequencies frequencies;
+    const Frequencies* frequencies;
 };
 
 } // namespace veins
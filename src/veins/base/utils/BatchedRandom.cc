@@ -0,0 +1,151 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/base/utils/BatchedRandom.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace veins;
+
+BatchedRandom::BatchedRandom(cRNG* rng, size_t batchSize)
+    : rng(rng)
+    , batchSize(batchSize)
+{
+    ASSERT(rng);
+    ASSERT(batchSize > 0);
+}
+
+double BatchedRandom::uniform(double a, double b)
+{
+    return a + (b - a) * next(Distribution::uniform);
+}
+
+double BatchedRandom::normal(double mean, double stddev)
+{
+    return mean + stddev * next(Distribution::normal);
+}
+
+double BatchedRandom::exponential(double mean)
+{
+    return mean * next(Distribution::exponential);
+}
+
+double BatchedRandom::gamma_d(double alpha, double theta)
+{
+    return theta * next(Distribution::gamma, alpha);
+}
+
+void BatchedRandom::gamma_d(double alpha, double theta, double* out, size_t count)
+{
+    while (count > 0) {
+        Batch& batch = getBatch(Distribution::gamma, alpha);
+        size_t n = std::min(count, batch.values.size() - batch.next);
+        const double* values = batch.values.data() + batch.next;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = theta * values[i];
+        }
+        batch.next += n;
+        out += n;
+        count -= n;
+    }
+}
+
+void BatchedRandom::gamma_d(cRNG* rng, double alpha, double* out, size_t count)
+{
+    ASSERT(alpha > 0);
+
+    // for alpha < 1, draw from gamma(alpha + 1) and scale by U^(1/alpha)
+    const bool boost = alpha < 1;
+    const double d = (boost ? alpha + 1 : alpha) - 1.0 / 3;
+    const double c = 1 / std::sqrt(9 * d);
+
+    for (size_t i = 0; i < count; ++i) {
+        double value;
+        while (true) {
+            double x;
+            double v;
+            do {
+                x = omnetpp::normal(rng, 0, 1);
+                v = 1 + c * x;
+            } while (v <= 0);
+            v = v * v * v;
+            double u = rng->doubleRand();
+            if (u < 1 - 0.0331 * (x * x) * (x * x) || std::log(u) < 0.5 * x * x + d * (1 - v + std::log(v))) {
+                value = d * v;
+                break;
+            }
+        }
+        if (boost) {
+            value *= std::pow(rng->doubleRandNonz(), 1 / alpha);
+        }
+        out[i] = value;
+    }
+}
+
+BatchedRandom::Batch& BatchedRandom::getBatch(Distribution distribution, double shape)
+{
+    BatchKey key(distribution, shape);
+    if (!lastBatch || key != lastKey) {
+        lastBatch = &batches[key];
+        lastKey = key;
+    }
+    if (lastBatch->next >= lastBatch->values.size()) {
+        refill(distribution, shape, *lastBatch);
+    }
+    return *lastBatch;
+}
+
+double BatchedRandom::next(Distribution distribution, double shape)
+{
+    Batch& batch = getBatch(distribution, shape);
+    return batch.values[batch.next++];
+}
+
+void BatchedRandom::refill(Distribution distribution, double shape, Batch& batch)
+{
+    batch.values.resize(batchSize);
+    batch.next = 0;
+
+    // draw standardized variates only; location and scale are applied when they are handed out
+    switch (distribution) {
+    case Distribution::uniform:
+        for (auto& value : batch.values) {
+            value = rng->doubleRand();
+        }
+        break;
+    case Distribution::normal:
+        for (auto& value : batch.values) {
+            value = omnetpp::normal(rng, 0, 1);
+        }
+        break;
+    case Distribution::exponential:
+        for (auto& value : batch.values) {
+            value = omnetpp::exponential(rng, 1);
+        }
+        break;
+    case Distribution::gamma:
+        gamma_d(rng, shape, batch.values.data(), batch.values.size());
+        break;
+    }
+}
@@ -0,0 +1,122 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Draws random variates from a dedicated RNG in batches.
+ *
+ * For every distribution and shape parameter, a batch of standardized variates is generated at once and handed out one by one;
+ * location and scale parameters are applied when a variate is handed out, so batches are shared across calls with different power levels, distances, etc.
+ * Variates have the same distribution as the corresponding OMNeT++ functions (e.g., gamma_d()), and the sequence handed out only depends on the seed of the RNG and the order of calls,
+ * so results stay reproducible for a given seed (though they differ from drawing each variate individually).
+ *
+ * Analogue models can use this to avoid one RNG round trip per reception or per frequency bin.
+ *
+ * @see BasePhyLayer
+ * @see NakagamiFading
+ */
+class VEINS_API BatchedRandom {
+public:
+    /**
+     * Create batches drawn from the given RNG.
+     *
+     * @param rng the RNG to draw from, should not be used by anything else
+     * @param batchSize number of variates to generate at once
+     */
+    BatchedRandom(cRNG* rng, size_t batchSize = 1024);
+
+    /**
+     * Returns a variate drawn from U(a, b).
+     */
+    double uniform(double a, double b);
+
+    /**
+     * Returns a variate drawn from N(mean, stddev^2).
+     */
+    double normal(double mean, double stddev);
+
+    /**
+     * Returns a variate drawn from an exponential distribution with the given mean.
+     */
+    double exponential(double mean);
+
+    /**
+     * Returns a variate drawn from a gamma distribution with shape alpha and scale theta.
+     */
+    double gamma_d(double alpha, double theta);
+
+    /**
+     * Fill an array with count variates drawn from a gamma distribution with shape alpha and scale theta.
+     */
+    void gamma_d(double alpha, double theta, double* out, size_t count);
+
+    /**
+     * Fill an array with count variates drawn from a gamma distribution with shape alpha and scale 1, using rng directly.
+     *
+     * Uses the same method as OMNeT++'s gamma_d() (Marsaglia and Tsang, 2000), but sets it up only once for all variates.
+     */
+    static void gamma_d(cRNG* rng, double alpha, double* out, size_t count);
+
+private:
+    enum class Distribution {
+        uniform,
+        normal,
+        exponential,
+        gamma,
+    };
+
+    struct Batch {
+        std::vector<double> values;
+        size_t next = 0;
+    };
+
+    typedef std::pair<Distribution, double> BatchKey;
+
+    /**
+     * Returns the batch of standardized variates of a distribution, refilling it if it has been used up.
+     */
+    Batch& getBatch(Distribution distribution, double shape = 0);
+
+    /**
+     * Returns the next standardized variate of a distribution.
+     */
+    double next(Distribution distribution, double shape = 0);
+
+    void refill(Distribution distribution, double shape, Batch& batch);
+
+    cRNG* rng;
+    size_t batchSize;
+    std::map<BatchKey, Batch> batches;
+    BatchKey lastKey; /**< key of the batch used most recently, models mostly draw from the same one repeatedly */
+    Batch* lastBatch = nullptr; /**< batch used most recently (map entries stay valid) */
+};
+
+} // namespace veins
@@ -0,0 +1,114 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/base/utils/ObjectPool.h"
+
+#include <algorithm>
+#include <new>
+
+namespace veins {
+
+ObjectPool::ObjectPool(std::string name, size_t objectSize, size_t maxFreeObjects)
+    : name(name)
+    , objectSize(objectSize)
+    , maxFreeObjects(maxFreeObjects)
+{
+    registry().push_back(this);
+}
+
+ObjectPool::~ObjectPool()
+{
+    for (auto p : freeBlocks) {
+        ::operator delete(p);
+    }
+    auto& pools = registry();
+    pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+}
+
+void* ObjectPool::allocate(size_t size)
+{
+    if (size != objectSize) return ::operator new(size);
+
+    numAllocations++;
+    if (freeBlocks.empty()) return ::operator new(size);
+
+    numHits++;
+    void* p = freeBlocks.back();
+    freeBlocks.pop_back();
+    return p;
+}
+
+void ObjectPool::release(void* p, size_t size)
+{
+    if (!p) return;
+    if (size != objectSize || freeBlocks.size() >= maxFreeObjects) {
+        ::operator delete(p);
+        return;
+    }
+    freeBlocks.push_back(p);
+}
+
+const std::string& ObjectPool::getName() const
+{
+    return name;
+}
+
+uint64_t ObjectPool::getNumAllocations() const
+{
+    return numAllocations;
+}
+
+uint64_t ObjectPool::getNumHits() const
+{
+    return numHits;
+}
+
+double ObjectPool::getHitRate() const
+{
+    if (numAllocations == 0) return 0;
+    return static_cast<double>(numHits) / numAllocations;
+}
+
+size_t ObjectPool::getNumFree() const
+{
+    return freeBlocks.size();
+}
+
+void ObjectPool::resetStatistics()
+{
+    numAllocations = 0;
+    numHits = 0;
+}
+
+const std::vector<ObjectPool*>& ObjectPool::getPools()
+{
+    return registry();
+}
+
+std::vector<ObjectPool*>& ObjectPool::registry()
+{
+    static std::vector<ObjectPool*> pools;
+    return pools;
+}
+
+} // namespace veins
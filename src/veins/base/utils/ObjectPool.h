@@ -0,0 +1,144 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Free list of fixed-size memory blocks for frequently allocated objects.
+ *
+ * Memory released to the pool is kept and handed out again on the next allocation of the same size,
+ * so objects that are created and destroyed for every frame do not go through the system allocator each time.
+ * Requests for any other size (e.g., from a subclass of the pooled type) are forwarded to the global allocator.
+ *
+ * All pools register themselves globally, so their statistics can be reset at the start of a run and recorded at its end.
+ * Pools are not thread-safe.
+ *
+ * @see Pooled
+ * @see BaseWorldUtility
+ */
+class VEINS_API ObjectPool {
+public:
+    /**
+     * Create a pool for objects of the given size.
+     *
+     * @param name name to report statistics under
+     * @param objectSize size of the objects managed by this pool in bytes
+     * @param maxFreeObjects maximum number of released blocks to keep for reuse
+     */
+    ObjectPool(std::string name, size_t objectSize, size_t maxFreeObjects = 65536);
+    ~ObjectPool();
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * Return memory for an object of the given size, preferring previously released blocks.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Return memory obtained from allocate() to the pool.
+     */
+    void release(void* p, size_t size);
+
+    const std::string& getName() const;
+
+    /**
+     * Number of allocations of the pooled size.
+     */
+    uint64_t getNumAllocations() const;
+
+    /**
+     * Number of allocations that were served from released blocks.
+     */
+    uint64_t getNumHits() const;
+
+    /**
+     * Fraction of allocations that were served from released blocks.
+     */
+    double getHitRate() const;
+
+    /**
+     * Number of released blocks currently kept for reuse.
+     */
+    size_t getNumFree() const;
+
+    /**
+     * Start counting allocations and hits from zero, e.g., at the start of a new run in the same process.
+     */
+    void resetStatistics();
+
+    /**
+     * All pools currently in existence.
+     */
+    static const std::vector<ObjectPool*>& getPools();
+
+private:
+    static std::vector<ObjectPool*>& registry();
+
+    std::string name;
+    size_t objectSize;
+    size_t maxFreeObjects;
+    std::vector<void*> freeBlocks;
+    uint64_t numAllocations = 0;
+    uint64_t numHits = 0;
+};
+
+/**
+ * Mixin that makes new and delete of a class go through an ObjectPool.
+ *
+ * Use as an additional base class, passing the class itself as template argument:
+ * @code
+ * class Foo : public Bar, public Pooled<Foo> { ... };
+ * @endcode
+ *
+ * Messages are pooled by declaring them with @customize(true) and deriving the actual class from the generated base class and Pooled (see AirFrame11p).
+ */
+template <typename T>
+class Pooled {
+public:
+    static void* operator new(size_t size)
+    {
+        return getPool().allocate(size);
+    }
+
+    static void operator delete(void* p, size_t size)
+    {
+        getPool().release(p, size);
+    }
+
+    static ObjectPool& getPool()
+    {
+        static ObjectPool pool(opp_typename(typeid(T)), sizeof(T));
+        return pool;
+    }
+};
+
+} // namespace veins
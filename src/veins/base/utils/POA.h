@@ -62,7 +62,11 @@ public:
     POA(AntennaPosition pos, Coord orientation, std::shared_ptr<Antenna> antenna)
         : pos(pos)
         , orientation(orientation)
-        , antenna(antenna){};
+        , antenna(std::move(antenna)){};
+    POA(const POA&) = default;
+    POA(POA&&) = default;
+    POA& operator=(const POA&) = default;
+    POA& operator=(POA&&) = default;
     virtual ~POA(){};
 };
 
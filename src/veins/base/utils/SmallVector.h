@@ -0,0 +1,214 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * A contiguous, fixed-length array of values that keeps up to N elements inline.
+ *
+ * Arrays of at most N elements live inside the object itself and need no heap allocation.
+ * Longer arrays are allocated on the heap.
+ * Moving a SmallVector transfers its heap allocation (if any) without copying elements.
+ *
+ * Only trivially copyable value types are supported.
+ */
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector only supports trivially copyable types");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    /**
+     * Create an array of count copies of value.
+     */
+    SmallVector(size_t count, const T& value)
+    {
+        reset(count);
+        std::fill(begin(), end(), value);
+    }
+
+    SmallVector(const SmallVector& other)
+    {
+        reset(other.count);
+        if (count) std::memcpy(data(), other.data(), count * sizeof(T));
+    }
+
+    SmallVector(SmallVector&& other) noexcept
+    {
+        steal(other);
+    }
+
+    ~SmallVector()
+    {
+        delete[] heap;
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this == &other) return *this;
+        reset(other.count);
+        if (count) std::memcpy(data(), other.data(), count * sizeof(T));
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this == &other) return *this;
+        delete[] heap;
+        heap = nullptr;
+        steal(other);
+        return *this;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    /**
+     * Predicate testing whether the elements are stored inline (i.e., not on the heap).
+     */
+    bool isInline() const
+    {
+        return heap == nullptr;
+    }
+
+    /**
+     * Access the elements directly. Returns nullptr if there are none.
+     */
+    T* data()
+    {
+        if (heap) return heap;
+        return count ? inlineValues : nullptr;
+    }
+
+    /**
+     * Access the elements directly. Returns nullptr if there are none.
+     */
+    const T* data() const
+    {
+        if (heap) return heap;
+        return count ? inlineValues : nullptr;
+    }
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + count;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + count;
+    }
+
+    T& operator[](size_t index)
+    {
+        return data()[index];
+    }
+
+    const T& operator[](size_t index) const
+    {
+        return data()[index];
+    }
+
+    T& at(size_t index)
+    {
+        if (index >= count) throw std::out_of_range("SmallVector::at");
+        return data()[index];
+    }
+
+    const T& at(size_t index) const
+    {
+        if (index >= count) throw std::out_of_range("SmallVector::at");
+        return data()[index];
+    }
+
+private:
+    /**
+     * Make room for newCount elements, discarding the current contents.
+     */
+    void reset(size_t newCount)
+    {
+        if (newCount > N && newCount > heapCapacity) {
+            delete[] heap;
+            heap = new T[newCount];
+            heapCapacity = newCount;
+        }
+        else if (newCount <= N && heap) {
+            delete[] heap;
+            heap = nullptr;
+            heapCapacity = 0;
+        }
+        count = newCount;
+    }
+
+    /**
+     * Take over the contents of other, leaving it empty. Expects this to own no heap memory.
+     */
+    void steal(SmallVector& other)
+    {
+        count = other.count;
+        heap = other.heap;
+        heapCapacity = other.heapCapacity;
+        if (!heap && count) std::memcpy(inlineValues, other.inlineValues, count * sizeof(T));
+        other.heap = nullptr;
+        other.heapCapacity = 0;
+        other.count = 0;
+    }
+
+    size_t count = 0;
+    T* heap = nullptr;
+    size_t heapCapacity = 0;
+    T inlineValues[N];
+};
+
+} // namespace veins
@@ -57,7 +57,7 @@ void NakagamiFading::filterSignal(Signal* signal)
     }
 
     // calculate average RX power
-    double recvPower_mW = (RNGCONTEXT gamma_d(m, sendPower_mW / 1000 / m)) * 1000.0;
+    double recvPower_mW = (random ? random->gamma_d(m, sendPower_mW / 1000 / m) : RNGCONTEXT gamma_d(m, sendPower_mW / 1000 / m)) * 1000.0;
     if (recvPower_mW > sendPower_mW) {
         recvPower_mW = sendPower_mW;
     }
@@ -26,6 +26,7 @@
 #include "veins/base/phyLayer/AnalogueModel.h"
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/messages/AirFrame_m.h"
+#include "veins/base/utils/BatchedRandom.h"
 
 namespace veins {
 
@@ -45,10 +46,14 @@ namespace veins {
 class VEINS_API NakagamiFading : public AnalogueModel {
 
 public:
-    NakagamiFading(cComponent* owner, bool constM, double m)
+    /**
+     * @param random batched random variates to draw fading from, or nullptr to draw from the RNG of the current context
+     */
+    NakagamiFading(cComponent* owner, bool constM, double m, BatchedRandom* random = nullptr)
         : AnalogueModel(owner)
         , constM(constM)
         , m(m)
+        , random(random)
     {
     }
 
@@ -64,6 +69,9 @@ protected:
 
     /** @brief The value of the coefficient m */
     double m;
+
+    /** @brief Source of batched random variates (if any) */
+    BatchedRandom* random;
 };
 
 } // namespace veins
@@ -46,3 +46,8 @@ void SimpleObstacleShadowing::filterSignal(Signal* signal)
 
     *signal *= factor;
 }
+
+void SimpleObstacleShadowing::prepareTransmission(const std::vector<std::pair<Coord, Coord>>& links)
+{
+    obstacleControl.precalculateAttenuation(links);
+}
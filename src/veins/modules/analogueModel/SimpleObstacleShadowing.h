@@ -74,6 +74,16 @@ public:
      */
     void filterSignal(Signal* signal) override;
 
+    bool needsTransmissionPreparation() const override
+    {
+        return obstacleControl.isPrecalculatingAttenuation();
+    }
+
+    /**
+     * @brief Calculates the attenuation for all receivers of a transmission in parallel, so filterSignal finds it in ObstacleControl's cache.
+     */
+    void prepareTransmission(const std::vector<std::pair<Coord, Coord>>& links) override;
+
     bool neverIncreasesPower() override
     {
         return true;
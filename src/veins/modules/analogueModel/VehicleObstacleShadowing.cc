@@ -20,15 +20,19 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <algorithm>
+#include <cmath>
+
 #include "veins/modules/analogueModel/VehicleObstacleShadowing.h"
 
 using namespace veins;
 
-VehicleObstacleShadowing::VehicleObstacleShadowing(cComponent* owner, VehicleObstacleControl& vehicleObstacleControl, bool useTorus, const Coord& playgroundSize)
+VehicleObstacleShadowing::VehicleObstacleShadowing(cComponent* owner, VehicleObstacleControl& vehicleObstacleControl, bool useTorus, const Coord& playgroundSize, bool interpolateKnifeEdgeLoss)
     : AnalogueModel(owner)
     , vehicleObstacleControl(vehicleObstacleControl)
     , useTorus(useTorus)
     , playgroundSize(playgroundSize)
+    , interpolateKnifeEdgeLoss(interpolateKnifeEdgeLoss)
 {
     if (useTorus) throw cRuntimeError("VehicleObstacleShadowing does not work on torus-shaped playgrounds");
 }
@@ -47,15 +51,24 @@ void VehicleObstacleShadowing::filterSignal(Signal* signal)
     potentialObstacles.insert(potentialObstacles.begin(), std::make_pair(0, senderHeight));
     potentialObstacles.emplace_back(senderPos.distance(receiverPos), receiverHeight);
 
-    auto attenuationDB = VehicleObstacleControl::getVehicleAttenuationDZ(potentialObstacles, Signal(signal->getSpectrum()));
+    // wavelength tables only need to be recomputed when the spectrum changes (which it rarely does)
+    const Spectrum& spectrum = signal->getSpectrum();
+    if (!(spectrum == wavelengthSpectrum)) {
+        wavelengthSpectrum = spectrum;
+        invSqrtWavelengths = VehicleObstacleControl::getInvSqrtWavelengths(spectrum);
+    }
+
+    const size_t numValues = signal->getNumValues();
+    ASSERT(numValues == invSqrtWavelengths.size());
+    attenuationDB.resize(numValues);
+    VehicleObstacleControl::getVehicleAttenuationDZ(potentialObstacles, invSqrtWavelengths.data(), numValues, attenuationDB.data(), interpolateKnifeEdgeLoss);
 
-    EV_TRACE << "t=" << simTime() << ": Attenuation by vehicles is " << attenuationDB << std::endl;
+    EV_TRACE << "t=" << simTime() << ": Attenuation by " << potentialObstacles.size() - 2 << " potential obstacles is up to " << *std::max_element(attenuationDB.begin(), attenuationDB.end()) << " dB" << std::endl;
 
-    // convert from "dB loss" to a multiplicative factor
-    Signal attenuation(attenuationDB.getSpectrum());
-    for (uint16_t i = 0; i < attenuation.getNumValues(); i++) {
-        attenuation.at(i) = pow(10.0, -attenuationDB.at(i) / 10.0);
+    // convert from "dB loss" to a multiplicative factor, i.e., 10^(-dB / 10)
+    const double factor = -std::log(10.0) / 10.0;
+    double* values = signal->getValues();
+    for (size_t i = 0; i < numValues; i++) {
+        values[i] *= std::exp(factor * attenuationDB[i]);
     }
-
-    *signal *= attenuation;
 }
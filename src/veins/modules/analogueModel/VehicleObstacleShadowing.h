@@ -27,11 +27,13 @@
 #include "veins/modules/obstacle/VehicleObstacleControl.h"
 #include "veins/base/utils/Move.h"
 #include "veins/base/messages/AirFrame_m.h"
+#include "veins/base/toolbox/Spectrum.h"
 
 using veins::AirFrame;
 using veins::VehicleObstacleControl;
 
 #include <cstdlib>
+#include <vector>
 
 namespace veins {
 
@@ -52,6 +54,18 @@ protected:
     /** @brief The size of the playground.*/
     const Coord& playgroundSize;
 
+    /** @brief Whether to interpolate the knife-edge diffraction loss from a table (deviating by less than 0.0005 dB per obstacle) instead of computing it exactly */
+    const bool interpolateKnifeEdgeLoss;
+
+    /** @brief Spectrum that invSqrtWavelengths was computed for */
+    Spectrum wavelengthSpectrum;
+
+    /** @brief 1 / sqrt(lambda) for each frequency of wavelengthSpectrum */
+    std::vector<double> invSqrtWavelengths;
+
+    /** @brief Buffer for the attenuation (in dB) of each frequency */
+    std::vector<double> attenuationDB;
+
 public:
     /**
      * @brief Initializes the analogue model. myMove and playgroundSize
@@ -64,8 +78,9 @@ public:
      * @param vehicleObstacleControl reference to global VehicleObstacleControl module
      * @param useTorus information about the playground the host is moving in
      * @param playgroundSize information about the playground the host is moving in
+     * @param interpolateKnifeEdgeLoss whether to trade exactness (by less than 0.0005 dB per obstacle) for speed, see VehicleObstacleControl::addVehicleAttenuationSingle
      */
-    VehicleObstacleShadowing(cComponent* owner, VehicleObstacleControl& vehicleObstacleControl, bool useTorus, const Coord& playgroundSize);
+    VehicleObstacleShadowing(cComponent* owner, VehicleObstacleControl& vehicleObstacleControl, bool useTorus, const Coord& playgroundSize, bool interpolateKnifeEdgeLoss = false);
 
     /**
      * @brief Filters a specified Signal by adding an attenuation
@@ -69,13 +69,6 @@ void DemoBaseApplLayer::initialize(int stage)
 
         sendBeaconEvt = new cMessage("beacon evt", SEND_BEACON_EVT);
         sendWSAEvt = new cMessage("wsa evt", SEND_WSA_EVT);
-
-        generatedBSMs = 0;
-        generatedWSAs = 0;
-        generatedWSMs = 0;
-        receivedBSMs = 0;
-        receivedWSAs = 0;
-        receivedWSMs = 0;
     }
     else if (stage == 1) {
 
@@ -261,6 +254,19 @@ void DemoBaseApplLayer::finish()
     recordScalar("receivedWSAs", receivedWSAs);
 }
 
+void DemoBaseApplLayer::prepareForRecycling()
+{
+    BaseApplLayer::prepareForRecycling();
+
+    cancelAndDelete(sendBeaconEvt);
+    sendBeaconEvt = nullptr;
+    cancelAndDelete(sendWSAEvt);
+    sendWSAEvt = nullptr;
+
+    findHost()->unsubscribe(BaseMobility::mobilityStateChangedSignal, this);
+    findHost()->unsubscribe(TraCIMobility::parkingStateChangedSignal, this);
+}
+
 DemoBaseApplLayer::~DemoBaseApplLayer()
 {
     cancelAndDelete(sendBeaconEvt);
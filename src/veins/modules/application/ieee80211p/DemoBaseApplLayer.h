@@ -28,7 +28,7 @@
 #include "veins/modules/utility/Consts80211p.h"
 #include "veins/modules/messages/BaseFrame1609_4_m.h"
 #include "veins/modules/messages/DemoServiceAdvertisement_m.h"
-#include "veins/modules/messages/DemoSafetyMessage_m.h"
+#include "veins/modules/messages/DemoSafetyMessage.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
 #include "veins/modules/mac/ieee80211p/DemoBaseApplLayerToMac1609_4Interface.h"
 #include "veins/modules/mobility/traci/TraCIMobility.h"
@@ -62,6 +62,9 @@ public:
     void initialize(int stage) override;
     void finish() override;
 
+    /** @brief cancels the periodic events and unsubscribes from the host, keeping the statistics (see RecyclableModule) */
+    void prepareForRecycling() override;
+
     void receiveSignal(cComponent* source, simsignal_t signalID, cObject* obj, cObject* details) override;
 
     enum DemoApplMessageKinds {
@@ -170,16 +173,16 @@ protected:
     int mySCH;
 
     /* stats */
-    uint32_t generatedWSMs;
-    uint32_t generatedWSAs;
-    uint32_t generatedBSMs;
-    uint32_t receivedWSMs;
-    uint32_t receivedWSAs;
-    uint32_t receivedBSMs;
+    uint32_t generatedWSMs = 0;
+    uint32_t generatedWSAs = 0;
+    uint32_t generatedBSMs = 0;
+    uint32_t receivedWSMs = 0;
+    uint32_t receivedWSAs = 0;
+    uint32_t receivedBSMs = 0;
 
     /* messages for periodic events such as beacon and WSA transmissions */
-    cMessage* sendBeaconEvt;
-    cMessage* sendWSAEvt;
+    cMessage* sendBeaconEvt = nullptr;
+    cMessage* sendWSAEvt = nullptr;
 };
 
 } // namespace veins
@@ -44,6 +44,19 @@ void MyVeinsApp::finish()
     // statistics recording goes here
 }
 
+void MyVeinsApp::prepareForRecycling()
+{
+    DemoBaseApplLayer::prepareForRecycling();
+    // cancelling self messages and unsubscribing from signals goes here,
+    // so the module can be re-used for another vehicle (see RecyclableModule)
+}
+
+void MyVeinsApp::reinitialize(int stage)
+{
+    // statistics should be kept here, everything else is initialized again
+    initialize(stage);
+}
+
 void MyVeinsApp::onBSM(DemoSafetyMessage* bsm)
 {
     // Your application has received a beacon message from another car or RSU
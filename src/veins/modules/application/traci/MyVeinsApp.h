@@ -25,6 +25,7 @@
 #include "veins/veins.h"
 
 #include "veins/modules/application/ieee80211p/DemoBaseApplLayer.h"
+#include "veins/base/modules/RecyclableModule.h"
 
 using namespace omnetpp;
 
@@ -40,11 +41,18 @@ namespace veins {
  *
  */
 
-class VEINS_API MyVeinsApp : public DemoBaseApplLayer {
+class VEINS_API MyVeinsApp : public DemoBaseApplLayer, public RecyclableModule {
 public:
     void initialize(int stage) override;
     void finish() override;
 
+    void prepareForRecycling() override;
+    void reinitialize(int stage) override;
+    int numReinitStages() const override
+    {
+        return numInitStages();
+    }
+
 protected:
     void onBSM(DemoSafetyMessage* bsm) override;
     void onWSM(BaseFrame1609_4* wsm) override;
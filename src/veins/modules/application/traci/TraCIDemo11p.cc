@@ -38,6 +38,17 @@ void TraCIDemo11p::initialize(int stage)
     }
 }
 
+void TraCIDemo11p::prepareForRecycling()
+{
+    DemoBaseApplLayer::prepareForRecycling();
+
+    cancelAndDelete(scheduledMessage);
+    scheduledMessage = nullptr;
+
+    // undo the coloring of the host
+    findHost()->getDisplayString().setTagArg("i", 1, "");
+}
+
 void TraCIDemo11p::onWSA(DemoServiceAdvertisment* wsa)
 {
     if (currentSubscribedServiceId == -1) {
@@ -62,7 +73,8 @@ void TraCIDemo11p::onWSM(BaseFrame1609_4* frame)
         // repeat the received traffic update once in 2 seconds plus some random delay
         wsm->setSenderAddress(myId);
         wsm->setSerial(3);
-        scheduleAt(simTime() + 2 + uniform(0.01, 0.2), wsm->dup());
+        scheduledMessage = wsm->dup();
+        scheduleAt(simTime() + 2 + uniform(0.01, 0.2), scheduledMessage);
     }
 }
 
@@ -77,6 +89,7 @@ void TraCIDemo11p::handleSelfMsg(cMessage* msg)
             // stop service advertisements
             stopService();
             delete (wsm);
+            scheduledMessage = nullptr;
         }
         else {
             scheduleAt(simTime() + 1, wsm);
@@ -105,6 +118,7 @@ void TraCIDemo11p::handlePositionUpdate(cObject* obj)
             if (dataOnSch) {
                 startService(Channel::sch2, 42, "Traffic Information Service");
                 // started service and server advertising, schedule message to self to send later
+                scheduledMessage = wsm;
                 scheduleAt(computeAsynchronousSendingTime(1, ChannelType::service), wsm);
             }
             else {
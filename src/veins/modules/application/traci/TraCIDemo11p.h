@@ -23,6 +23,7 @@
 #pragma once
 
 #include "veins/modules/application/ieee80211p/DemoBaseApplLayer.h"
+#include "veins/base/modules/RecyclableModule.h"
 
 namespace veins {
 
@@ -40,14 +41,25 @@ namespace veins {
  *
  */
 
-class VEINS_API TraCIDemo11p : public DemoBaseApplLayer {
+class VEINS_API TraCIDemo11p : public DemoBaseApplLayer, public RecyclableModule {
 public:
     void initialize(int stage) override;
 
+    void prepareForRecycling() override;
+    void reinitialize(int stage) override
+    {
+        initialize(stage);
+    }
+    int numReinitStages() const override
+    {
+        return numInitStages();
+    }
+
 protected:
     simtime_t lastDroveAt;
     bool sentMessage;
     int currentSubscribedServiceId;
+    cMessage* scheduledMessage = nullptr; /**< message scheduled to be sent (again) on the service channel, if any */
 
 protected:
     void onWSM(BaseFrame1609_4* wsm) override;
@@ -139,21 +139,6 @@ void Mac1609_4::initialize(int stage)
             setActiveChannel(ChannelType::control);
         }
 
-        // stats
-        statsReceivedPackets = 0;
-        statsReceivedBroadcasts = 0;
-        statsSentPackets = 0;
-        statsSentAcks = 0;
-        statsRetriesExceeded = 0;
-        statsTXRXLostPackets = 0;
-        statsSNIRLostPackets = 0;
-        statsDroppedPackets = 0;
-        statsNumTooLittleTime = 0;
-        statsNumInternalContention = 0;
-        statsNumBackoff = 0;
-        statsSlotsBackoff = 0;
-        statsTotalBusyTime = 0;
-
         idleChannel = true;
         lastBusy = simTime();
         channelIdle(true);
@@ -447,6 +432,29 @@ void Mac1609_4::finish()
     recordScalar("totalBusyTime", statsTotalBusyTime.dbl());
 }
 
+void Mac1609_4::prepareForRecycling()
+{
+    BaseMacLayer::prepareForRecycling();
+
+    // keep the statistics of the EDCA systems, which are re-created by initialize
+    for (auto&& p : myEDCA) {
+        statsNumInternalContention += p.second->statsNumInternalContention;
+        statsNumBackoff += p.second->statsNumBackoff;
+        statsSlotsBackoff += p.second->statsSlotsBackoff;
+    }
+    myEDCA.clear();
+
+    cancelAndDelete(nextMacEvent);
+    nextMacEvent = nullptr;
+    cancelAndDelete(nextChannelSwitch);
+    nextChannelSwitch = nullptr;
+    cancelAndDelete(stopIgnoreChannelStateMsg);
+    stopIgnoreChannelStateMsg = nullptr;
+
+    lastMac.reset();
+    handledUnicastToApp.clear();
+}
+
 Mac1609_4::~Mac1609_4()
 {
     if (nextMacEvent) {
@@ -34,11 +34,12 @@
 #include "veins/modules/utility/Consts80211p.h"
 #include "veins/modules/utility/MacToPhyControlInfo11p.h"
 #include "veins/base/utils/FindModule.h"
-#include "veins/modules/messages/Mac80211Pkt_m.h"
+#include "veins/modules/messages/Mac80211Pkt.h"
 #include "veins/modules/messages/BaseFrame1609_4_m.h"
 #include "veins/modules/messages/AckTimeOutMessage_m.h"
 #include "veins/modules/messages/Mac80211Ack_m.h"
 #include "veins/base/modules/BaseMacLayer.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/modules/utility/ConstsPhy.h"
 #include "veins/modules/utility/HasLogProxy.h"
 
@@ -65,7 +66,7 @@ namespace veins {
 
 class DeciderResult80211;
 
-class VEINS_API Mac1609_4 : public BaseMacLayer, public DemoBaseApplLayerToMac1609_4Interface {
+class VEINS_API Mac1609_4 : public BaseMacLayer, public DemoBaseApplLayerToMac1609_4Interface, public RecyclableModule {
 
 public:
     // tell to anybody which is interested when the channel turns busy or idle
@@ -149,6 +150,17 @@ public:
     }
     ~Mac1609_4() override;
 
+    void prepareForRecycling() override;
+    void reinitialize(int stage) override
+    {
+        // statistics are not reset by initialize
+        initialize(stage);
+    }
+    int numReinitStages() const override
+    {
+        return numInitStages();
+    }
+
     /**
      * @brief return true if alternate access is enabled
      */
@@ -276,19 +288,19 @@ protected:
     bool idleChannel;
 
     /** @brief stats */
-    long statsReceivedPackets;
-    long statsReceivedBroadcasts;
-    long statsSentPackets;
-    long statsSentAcks;
-    long statsRetriesExceeded;
-    long statsTXRXLostPackets;
-    long statsSNIRLostPackets;
-    long statsDroppedPackets;
-    long statsNumTooLittleTime;
-    long statsNumInternalContention;
-    long statsNumBackoff;
-    long statsSlotsBackoff;
-    simtime_t statsTotalBusyTime;
+    long statsReceivedPackets = 0;
+    long statsReceivedBroadcasts = 0;
+    long statsSentPackets = 0;
+    long statsSentAcks = 0;
+    long statsRetriesExceeded = 0;
+    long statsTXRXLostPackets = 0;
+    long statsSNIRLostPackets = 0;
+    long statsDroppedPackets = 0;
+    long statsNumTooLittleTime = 0;
+    long statsNumInternalContention = 0;
+    long statsNumBackoff = 0;
+    long statsSlotsBackoff = 0;
+    simtime_t statsTotalBusyTime = 0;
 
     /** @brief The power (in mW) to transmit with.*/
     double txPower;
@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/ObjectPool.h"
+#include "veins/modules/messages/DemoSafetyMessage_m.h"
+
+namespace veins {
+
+/**
+ * Beacon sent by DemoBaseApplLayer.
+ *
+ * Released instances are recycled through an ObjectPool.
+ * The fields are defined in DemoSafetyMessage.msg.
+ */
+class VEINS_API DemoSafetyMessage : public DemoSafetyMessage_Base, public Pooled<DemoSafetyMessage> {
+public:
+    DemoSafetyMessage(const char* name = nullptr, short kind = 0)
+        : DemoSafetyMessage_Base(name, kind)
+    {
+    }
+
+    DemoSafetyMessage(const DemoSafetyMessage& other)
+        : DemoSafetyMessage_Base(other)
+    {
+    }
+
+    DemoSafetyMessage& operator=(const DemoSafetyMessage& other)
+    {
+        DemoSafetyMessage_Base::operator=(other);
+        return *this;
+    }
+
+    DemoSafetyMessage* dup() const override
+    {
+        return new DemoSafetyMessage(*this);
+    }
+};
+
+} // namespace veins
@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/ObjectPool.h"
+#include "veins/modules/messages/Mac80211Pkt_m.h"
+
+namespace veins {
+
+/**
+ * 802.11 MAC frame, created by Mac1609_4 for every transmission.
+ *
+ * Released instances are recycled through an ObjectPool.
+ * The fields are defined in Mac80211Pkt.msg.
+ */
+class VEINS_API Mac80211Pkt : public Mac80211Pkt_Base, public Pooled<Mac80211Pkt> {
+public:
+    Mac80211Pkt(const char* name = nullptr, short kind = 0)
+        : Mac80211Pkt_Base(name, kind)
+    {
+    }
+
+    Mac80211Pkt(const Mac80211Pkt& other)
+        : Mac80211Pkt_Base(other)
+    {
+    }
+
+    Mac80211Pkt& operator=(const Mac80211Pkt& other)
+    {
+        Mac80211Pkt_Base::operator=(other);
+        return *this;
+    }
+
+    Mac80211Pkt* dup() const override
+    {
+        return new Mac80211Pkt(*this);
+    }
+};
+
+} // namespace veins
@@ -26,12 +26,18 @@
 
 #include <iomanip>
 #include <sstream>
+#include <utility>
 
 using namespace veins::TraCIConstants;
 
 namespace veins {
 
 bool TraCIBuffer::timeAsDouble = true;
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+const bool TraCIBuffer::hostIsBigEndian = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+#else
+const bool TraCIBuffer::hostIsBigEndian = isBigEndian();
+#endif
 
 TraCIBuffer::TraCIBuffer()
     : buf()
@@ -40,7 +46,7 @@ TraCIBuffer::TraCIBuffer()
 }
 
 TraCIBuffer::TraCIBuffer(std::string buf)
-    : buf(buf)
+    : buf(std::move(buf))
 {
     buf_index = 0;
 }
@@ -50,9 +56,14 @@ bool TraCIBuffer::eof() const
     return buf_index == buf.length();
 }
 
+void TraCIBuffer::reserve(size_t size)
+{
+    buf.reserve(size);
+}
+
 void TraCIBuffer::set(std::string buf)
 {
-    this->buf = buf;
+    this->buf = std::move(buf);
     buf_index = 0;
 }
 
@@ -95,7 +106,15 @@ void TraCIBuffer::write(std::string inv)
 {
     uint32_t length = inv.length();
     write<uint32_t>(length);
-    for (size_t i = 0; i < length; ++i) write<char>(inv[i]);
+    buf.append(inv);
+}
+
+template <>
+void TraCIBuffer::write(StringView inv)
+{
+    uint32_t length = inv.size;
+    write<uint32_t>(length);
+    buf.append(inv.data, inv.size);
 }
 
 template <>
@@ -111,14 +130,25 @@ void TraCIBuffer::write(std::list<std::string> inv)
 template <>
 std::string TraCIBuffer::read()
 {
-    uint32_t length = read<uint32_t>();
-    if (length == 0) return std::string();
-    char obuf[length + 1];
+    StringView view = readStringView();
+    return std::string(view.data, view.size);
+}
 
-    for (size_t i = 0; i < length; ++i) read<char>(obuf[i]);
-    obuf[length] = 0;
+TraCIBuffer::StringView TraCIBuffer::readStringView()
+{
+    uint32_t length = read<uint32_t>();
+    require(length);
+    StringView view{buf.data() + buf_index, length};
+    buf_index += length;
+    return view;
+}
 
-    return std::string(obuf, length);
+TraCIBuffer TraCIBuffer::readSubBuffer(size_t size)
+{
+    require(size);
+    TraCIBuffer sub(buf.substr(buf_index, size));
+    buf_index += size;
+    return sub;
 }
 
 template <>
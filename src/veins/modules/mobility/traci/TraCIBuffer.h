@@ -22,7 +22,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "veins/veins.h"
@@ -37,67 +40,82 @@ bool VEINS_API isBigEndian();
 
 /**
  * Byte-buffer that stores values in TraCI byte-order
+ *
+ * Values are appended and read as a whole (with one bounds check and one byte swap per value).
  */
 class VEINS_API TraCIBuffer {
 public:
+    /**
+     * Reference to a string stored in a TraCIBuffer, valid as long as the buffer is neither modified nor destroyed
+     */
+    struct StringView {
+        const char* data;
+        size_t size;
+
+        std::string str() const
+        {
+            return std::string(data, size);
+        }
+        bool operator==(const std::string& other) const
+        {
+            return (size == other.size()) && (other.compare(0, size, data, size) == 0);
+        }
+        bool operator!=(const std::string& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
     TraCIBuffer();
     TraCIBuffer(std::string buf);
 
     template <typename T>
     T read()
     {
+        require(sizeof(T));
         T buf_to_return;
-        unsigned char* p_buf_to_return = reinterpret_cast<unsigned char*>(&buf_to_return);
-
-        if (isBigEndian()) {
-            for (size_t i = 0; i < sizeof(buf_to_return); ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                p_buf_to_return[i] = buf[buf_index++];
-            }
-        }
-        else {
-            for (size_t i = 0; i < sizeof(buf_to_return); ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                p_buf_to_return[sizeof(buf_to_return) - 1 - i] = buf[buf_index++];
-            }
-        }
-
-        return buf_to_return;
+        std::memcpy(&buf_to_return, buf.data() + buf_index, sizeof(T));
+        buf_index += sizeof(T);
+        return toFromNetworkByteOrder(buf_to_return);
     }
 
     template <typename T>
     void write(T inv)
     {
-        unsigned char* p_buf_to_send = reinterpret_cast<unsigned char*>(&inv);
-
-        if (isBigEndian()) {
-            for (size_t i = 0; i < sizeof(inv); ++i) {
-                buf += p_buf_to_send[i];
-            }
-        }
-        else {
-            for (size_t i = 0; i < sizeof(inv); ++i) {
-                buf += p_buf_to_send[sizeof(inv) - 1 - i];
-            }
-        }
+        inv = toFromNetworkByteOrder(inv);
+        buf.append(reinterpret_cast<const char*>(&inv), sizeof(T));
     }
 
     void readBuffer(unsigned char* buffer, size_t size)
     {
-        if (isBigEndian()) {
-            for (size_t i = 0; i < size; ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                buffer[i] = buf[buf_index++];
-            }
-        }
-        else {
-            for (size_t i = 0; i < size; ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                buffer[size - 1 - i] = buf[buf_index++];
-            }
-        }
+        require(size);
+        std::memcpy(buffer, buf.data() + buf_index, size);
+        buf_index += size;
+        if (!hostIsBigEndian) std::reverse(buffer, buffer + size);
     }
 
+    /**
+     * read a string without copying it (see StringView)
+     */
+    StringView readStringView();
+
+    /**
+     * return the value offset bytes past the current read position, without consuming it
+     */
+    template <typename T>
+    T peek(size_t offset = 0) const
+    {
+        require(offset + sizeof(T));
+        T value;
+        std::memcpy(&value, buf.data() + buf_index + offset, sizeof(T));
+        return toFromNetworkByteOrder(value);
+    }
+
+    /**
+     * consume the next size bytes, returning them as a buffer of their own
+     */
+    TraCIBuffer readSubBuffer(size_t size);
+
     template <typename T>
     T read(T& out)
     {
@@ -162,6 +180,12 @@ public:
     }
 
     bool eof() const;
+
+    /**
+     * allocate memory for a total of size bytes, so that writing up to that many bytes does not reallocate
+     */
+    void reserve(size_t size);
+
     void set(std::string buf);
     void clear();
     std::string str() const;
@@ -176,9 +200,82 @@ public:
     }
 
 private:
+    template <size_t size>
+    struct UnsignedOfSize;
+
+    static uint8_t byteSwap(uint8_t value)
+    {
+        return value;
+    }
+    static uint16_t byteSwap(uint16_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_bswap16(value);
+#else
+        return static_cast<uint16_t>((value >> 8) | (value << 8));
+#endif
+    }
+    static uint32_t byteSwap(uint32_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_bswap32(value);
+#else
+        return ((value >> 24) & 0x000000ffu) | ((value >> 8) & 0x0000ff00u) | ((value << 8) & 0x00ff0000u) | ((value << 24) & 0xff000000u);
+#endif
+    }
+    static uint64_t byteSwap(uint64_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_bswap64(value);
+#else
+        return (uint64_t(byteSwap(static_cast<uint32_t>(value))) << 32) | byteSwap(static_cast<uint32_t>(value >> 32));
+#endif
+    }
+
+    /**
+     * convert a value between host and TraCI (big endian) byte order
+     */
+    template <typename T>
+    static T toFromNetworkByteOrder(T value)
+    {
+        if (hostIsBigEndian) return value;
+        typedef typename UnsignedOfSize<sizeof(T)>::type Bits;
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        bits = byteSwap(bits);
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    /**
+     * throw unless at least size more bytes can be read
+     */
+    void require(size_t size) const
+    {
+        if (buf.size() - buf_index < size) throw cRuntimeError("Attempted to read past end of byte buffer");
+    }
+
     std::string buf;
     size_t buf_index;
     static bool timeAsDouble;
+    static const bool hostIsBigEndian;
+};
+
+template <>
+struct TraCIBuffer::UnsignedOfSize<1> {
+    typedef uint8_t type;
+};
+template <>
+struct TraCIBuffer::UnsignedOfSize<2> {
+    typedef uint16_t type;
+};
+template <>
+struct TraCIBuffer::UnsignedOfSize<4> {
+    typedef uint32_t type;
+};
+template <>
+struct TraCIBuffer::UnsignedOfSize<8> {
+    typedef uint64_t type;
 };
 
 template <>
@@ -186,6 +283,8 @@ std::vector<std::string> TraCIBuffer::readTypeChecked(int expectedTraCIType);
 template <>
 void VEINS_API TraCIBuffer::write(std::string inv);
 template <>
+void VEINS_API TraCIBuffer::write(StringView inv);
+template <>
 void VEINS_API TraCIBuffer::write(std::list<std::string> inv);
 template <>
 void TraCIBuffer::write(TraCICoord inv);
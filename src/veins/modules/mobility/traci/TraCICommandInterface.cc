@@ -57,6 +57,88 @@ bool TraCICommandInterface::isIgnoringGuiCommands()
     return ignoreGuiCommands;
 }
 
+void TraCICommandInterface::setStaticDataCacheEnabled(bool enabled)
+{
+    staticDataCacheEnabled = enabled;
+    if (!enabled) invalidateStaticDataCache();
+}
+
+void TraCICommandInterface::invalidateStaticDataCache()
+{
+    staticDataCache.clear();
+}
+
+void TraCICommandInterface::invalidateStaticDataCache(uint8_t commandId, std::string objectId)
+{
+    auto first = staticDataCache.lower_bound(StaticDataCacheKey(commandId, objectId, 0));
+    auto last = staticDataCache.upper_bound(StaticDataCacheKey(commandId, objectId, 0xff));
+    staticDataCache.erase(first, last);
+}
+
+bool TraCICommandInterface::isStaticVariable(uint8_t commandId, uint8_t variableId)
+{
+    switch (commandId) {
+    case CMD_GET_EDGE_VARIABLE:
+        return variableId == ID_LIST;
+    case CMD_GET_LANE_VARIABLE:
+        // not VAR_MAXSPEED, which can change during a run (e.g., by variable speed signs)
+        return (variableId == ID_LIST) || (variableId == VAR_SHAPE) || (variableId == LANE_EDGE_ID) || (variableId == VAR_LENGTH) || (variableId == VAR_WIDTH);
+    case CMD_GET_JUNCTION_VARIABLE:
+        return (variableId == ID_LIST) || (variableId == VAR_POSITION) || (variableId == VAR_SHAPE);
+    case CMD_GET_ROUTE_VARIABLE:
+        // not ID_LIST, as routes can be added during a run, but an existing route never changes
+        return variableId == VAR_EDGES;
+    case CMD_GET_VEHICLETYPE_VARIABLE:
+        // not ID_LIST, as vehicle types can be added during a run
+        return variableId != ID_LIST;
+    default:
+        return false;
+    }
+}
+
+TraCIBuffer TraCICommandInterface::queryVariable(uint8_t commandId, const std::string& objectId, uint8_t variableId, TraCIConnection::Result* result)
+{
+    if (!staticDataCacheEnabled || !isStaticVariable(commandId, variableId)) {
+        return connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    }
+
+    StaticDataCacheKey key(commandId, objectId, variableId);
+    auto i = staticDataCache.find(key);
+    if (i != staticDataCache.end()) {
+        staticDataCacheStatistics.hits++;
+        if (result) *result = TraCIConnection::Result(true, false, "");
+        return i->second;
+    }
+
+    staticDataCacheStatistics.misses++;
+    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    if ((result == nullptr) || result->success) staticDataCache[key] = buf;
+    return buf;
+}
+
+void TraCICommandInterface::enqueueVariable(uint8_t commandId, const std::string& objectId, uint8_t variableId, TraCIConnection::ResponseHandler handler)
+{
+    if (!staticDataCacheEnabled || !isStaticVariable(commandId, variableId)) {
+        connection.enqueue(commandId, TraCIBuffer() << variableId << objectId, true, handler);
+        return;
+    }
+
+    StaticDataCacheKey key(commandId, objectId, variableId);
+    auto i = staticDataCache.find(key);
+    if (i != staticDataCache.end()) {
+        staticDataCacheStatistics.hits++;
+        TraCIBuffer buf = i->second;
+        handler(buf);
+        return;
+    }
+
+    staticDataCacheStatistics.misses++;
+    connection.enqueue(commandId, TraCIBuffer() << variableId << objectId, true, [this, key, handler](TraCIBuffer& buf) {
+        staticDataCache[key] = buf;
+        handler(buf);
+    });
+}
+
 std::pair<uint32_t, std::string> TraCICommandInterface::getVersion()
 {
     TraCIConnection::Result result;
@@ -243,6 +325,7 @@ double TraCICommandInterface::getVehicleTypeMaxSpeed(std::string typeId)
 void TraCICommandInterface::setVehicleTypeMaxSpeed(std::string typeId, double maxSpeed)
 {
     genericSetDouble(CMD_SET_VEHICLETYPE_VARIABLE, typeId, VAR_MAXSPEED, maxSpeed);
+    invalidateStaticDataCache(CMD_GET_VEHICLETYPE_VARIABLE, typeId);
 }
 
 std::list<std::string> TraCICommandInterface::getRouteIds()
@@ -1011,6 +1094,16 @@ std::list<Coord> TraCICommandInterface::Polygon::getShape()
     return traci->genericGetCoordList(CMD_GET_POLYGON_VARIABLE, polyId, VAR_SHAPE, RESPONSE_GET_POLYGON_VARIABLE);
 }
 
+void TraCICommandInterface::Polygon::getTypeId(std::function<void(std::string)> handler)
+{
+    traci->genericGetString(CMD_GET_POLYGON_VARIABLE, polyId, VAR_TYPE, RESPONSE_GET_POLYGON_VARIABLE, handler);
+}
+
+void TraCICommandInterface::Polygon::getShape(std::function<void(std::list<Coord>)> handler)
+{
+    traci->genericGetCoordList(CMD_GET_POLYGON_VARIABLE, polyId, VAR_SHAPE, RESPONSE_GET_POLYGON_VARIABLE, handler);
+}
+
 void TraCICommandInterface::Polygon::setShape(const std::list<Coord>& points)
 {
     TraCIBuffer buf;
@@ -1162,6 +1255,11 @@ Coord TraCICommandInterface::Junction::getPosition()
     return traci->genericGetCoord(CMD_GET_JUNCTION_VARIABLE, junctionId, VAR_POSITION, RESPONSE_GET_JUNCTION_VARIABLE);
 }
 
+void TraCICommandInterface::Junction::getPosition(std::function<void(Coord)> handler)
+{
+    traci->genericGetCoord(CMD_GET_JUNCTION_VARIABLE, junctionId, VAR_POSITION, RESPONSE_GET_JUNCTION_VARIABLE, handler);
+}
+
 std::list<Coord> TraCICommandInterface::Junction::getShape()
 {
     return traci->genericGetCoordList(CMD_GET_JUNCTION_VARIABLE, junctionId, VAR_SHAPE, RESPONSE_GET_JUNCTION_VARIABLE);
@@ -1443,30 +1541,13 @@ std::string TraCICommandInterface::genericGetString(uint8_t commandId, std::stri
     uint8_t resultTypeId = TYPE_STRING;
     std::string res;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return res;
     }
 
-    uint8_t cmdLength;
-    buf >> cmdLength;
-    if (cmdLength == 0) {
-        uint32_t cmdLengthX;
-        buf >> cmdLengthX;
-    }
-    uint8_t commandId_r;
-    buf >> commandId_r;
-    ASSERT(commandId_r == responseId);
-    uint8_t varId;
-    buf >> varId;
-    ASSERT(varId == variableId);
-    std::string objectId_r;
-    buf >> objectId_r;
-    ASSERT(objectId_r == objectId);
-    uint8_t resType_r;
-    buf >> resType_r;
-    ASSERT(resType_r == resultTypeId);
+    readGetResponseHeader(buf, responseId, variableId, objectId, resultTypeId);
     buf >> res;
 
     ASSERT(buf.eof());
@@ -1481,30 +1562,13 @@ Coord TraCICommandInterface::genericGetCoord(uint8_t commandId, std::string obje
     double x;
     double y;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return Coord();
     }
 
-    uint8_t cmdLength;
-    buf >> cmdLength;
-    if (cmdLength == 0) {
-        uint32_t cmdLengthX;
-        buf >> cmdLengthX;
-    }
-    uint8_t commandId_r;
-    buf >> commandId_r;
-    ASSERT(commandId_r == responseId);
-    uint8_t varId;
-    buf >> varId;
-    ASSERT(varId == variableId);
-    std::string objectId_r;
-    buf >> objectId_r;
-    ASSERT(objectId_r == objectId);
-    uint8_t resType_r;
-    buf >> resType_r;
-    ASSERT(resType_r == resultTypeId);
+    readGetResponseHeader(buf, responseId, variableId, objectId, resultTypeId);
     buf >> x;
     buf >> y;
 
@@ -1519,7 +1583,7 @@ double TraCICommandInterface::genericGetDouble(uint8_t commandId, std::string ob
     uint8_t resultTypeId = TYPE_DOUBLE;
     double res;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return 0;
@@ -1562,7 +1626,7 @@ simtime_t TraCICommandInterface::genericGetTime(uint8_t commandId, std::string o
     uint8_t resultTypeId = getTimeType();
     simtime_t res;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return res;
@@ -1599,7 +1663,7 @@ uint8_t TraCICommandInterface::genericGetUnsignedByte(uint8_t commandId, std::st
     uint8_t resultTypeId = TYPE_UBYTE;
     int8_t res;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return 0;
@@ -1636,7 +1700,7 @@ int32_t TraCICommandInterface::genericGetInt(uint8_t commandId, std::string obje
     uint8_t resultTypeId = TYPE_INTEGER;
     int32_t res;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return 0;
@@ -1673,7 +1737,7 @@ std::list<std::string> TraCICommandInterface::genericGetStringList(uint8_t comma
     uint8_t resultTypeId = TYPE_STRINGLIST;
     std::list<std::string> res;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return res;
@@ -1716,12 +1780,71 @@ std::list<Coord> TraCICommandInterface::genericGetCoordList(uint8_t commandId, s
     uint8_t resultTypeId = TYPE_POLYGON;
     std::list<Coord> res;
 
-    TraCIBuffer buf = connection.query(commandId, TraCIBuffer() << variableId << objectId, result);
+    TraCIBuffer buf = queryVariable(commandId, objectId, variableId, result);
 
     if ((result != nullptr) && (!result->success)) {
         return res;
     }
 
+    readGetResponseHeader(buf, responseId, variableId, objectId, resultTypeId);
+    uint32_t count = buf.readByteOrFull<uint32_t>();
+    for (uint32_t i = 0; i < count; i++) {
+        double x;
+        buf >> x;
+        double y;
+        buf >> y;
+        res.push_back(connection.traci2omnet(TraCICoord(x, y)));
+    }
+
+    ASSERT(buf.eof());
+
+    return res;
+}
+
+void TraCICommandInterface::genericGetString(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, std::function<void(std::string)> handler)
+{
+    enqueueVariable(commandId, objectId, variableId, [=](TraCIBuffer& buf) {
+        readGetResponseHeader(buf, responseId, variableId, objectId, TYPE_STRING);
+        std::string res;
+        buf >> res;
+        ASSERT(buf.eof());
+        handler(res);
+    });
+}
+
+void TraCICommandInterface::genericGetCoord(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, std::function<void(Coord)> handler)
+{
+    enqueueVariable(commandId, objectId, variableId, [=](TraCIBuffer& buf) {
+        readGetResponseHeader(buf, responseId, variableId, objectId, POSITION_2D);
+        double x;
+        double y;
+        buf >> x;
+        buf >> y;
+        ASSERT(buf.eof());
+        handler(connection.traci2omnet(TraCICoord(x, y)));
+    });
+}
+
+void TraCICommandInterface::genericGetCoordList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, std::function<void(std::list<Coord>)> handler)
+{
+    enqueueVariable(commandId, objectId, variableId, [=](TraCIBuffer& buf) {
+        readGetResponseHeader(buf, responseId, variableId, objectId, TYPE_POLYGON);
+        std::list<Coord> res;
+        uint32_t count = buf.readByteOrFull<uint32_t>();
+        for (uint32_t i = 0; i < count; i++) {
+            double x;
+            buf >> x;
+            double y;
+            buf >> y;
+            res.push_back(connection.traci2omnet(TraCICoord(x, y)));
+        }
+        ASSERT(buf.eof());
+        handler(res);
+    });
+}
+
+void TraCICommandInterface::readGetResponseHeader(TraCIBuffer& buf, uint8_t responseId, uint8_t variableId, const std::string& objectId, uint8_t resultTypeId)
+{
     uint8_t cmdLength;
     buf >> cmdLength;
     if (cmdLength == 0) {
@@ -1740,18 +1863,6 @@ std::list<Coord> TraCICommandInterface::genericGetCoordList(uint8_t commandId, s
     uint8_t resType_r;
     buf >> resType_r;
     ASSERT(resType_r == resultTypeId);
-    uint32_t count = buf.readByteOrFull<uint32_t>();
-    for (uint32_t i = 0; i < count; i++) {
-        double x;
-        buf >> x;
-        double y;
-        buf >> y;
-        res.push_back(connection.traci2omnet(TraCICoord(x, y)));
-    }
-
-    ASSERT(buf.eof());
-
-    return res;
 }
 
 std::string TraCICommandInterface::Vehicle::getVType()
@@ -22,8 +22,11 @@
 
 #pragma once
 
+#include <functional>
 #include <list>
+#include <map>
 #include <string>
+#include <tuple>
 #include <stdint.h>
 
 #include "veins/modules/mobility/traci/TraCIColor.h"
@@ -67,6 +70,37 @@ public:
         DEPART_LANE_FIRST = -6, // The rightmost valid
     };
 
+    // Cache of static data
+    struct StaticDataCacheStatistics {
+        long hits = 0; /**< number of values served from the cache */
+        long misses = 0; /**< number of cacheable values that had to be queried from the TraCI server */
+    };
+
+    /**
+     * Enable or disable caching values that are static for a run (network geometry, vehicle type attributes, route edges), so each is only queried from the TraCI server once.
+     * Disabling the cache also clears it.
+     */
+    void setStaticDataCacheEnabled(bool enabled);
+    bool isStaticDataCacheEnabled() const
+    {
+        return staticDataCacheEnabled;
+    }
+
+    /**
+     * Forget all cached values, e.g., after changing static data by means other than this class
+     */
+    void invalidateStaticDataCache();
+
+    /**
+     * Forget all cached values of one object, e.g., invalidateStaticDataCache(CMD_GET_VEHICLETYPE_VARIABLE, typeId)
+     */
+    void invalidateStaticDataCache(uint8_t commandId, std::string objectId);
+
+    const StaticDataCacheStatistics& getStaticDataCacheStatistics() const
+    {
+        return staticDataCacheStatistics;
+    }
+
     // General methods that do not deal with a particular object in the simulation
     std::pair<uint32_t, std::string> getVersion();
     void setApiVersion(uint32_t apiVersion);
@@ -415,6 +449,13 @@ public:
 
         std::string getTypeId();
         std::list<Coord> getShape();
+
+        /**
+         * queue getting the type id or shape, calling handler with the result once the connection's command queue is flushed (see TraCIConnection::flush)
+         */
+        void getTypeId(std::function<void(std::string)> handler);
+        void getShape(std::function<void(std::list<Coord>)> handler);
+
         void setShape(const std::list<Coord>& points);
         void remove(int32_t layer);
 
@@ -467,6 +508,11 @@ public:
         Coord getPosition();
         std::list<Coord> getShape();
 
+        /**
+         * queue getting the position, calling handler with the result once the connection's command queue is flushed (see TraCIConnection::flush)
+         */
+        void getPosition(std::function<void(Coord)> handler);
+
     protected:
         TraCICommandInterface* traci;
         TraCIConnection* connection;
@@ -553,6 +599,26 @@ private:
     static const std::map<uint32_t, VersionConfig> versionConfigs;
     VersionConfig versionConfig;
 
+    typedef std::tuple<uint8_t, std::string, uint8_t> StaticDataCacheKey; /**< get command, object id, variable id */
+    bool staticDataCacheEnabled = false;
+    std::map<StaticDataCacheKey, TraCIBuffer> staticDataCache; /**< responses to get variable commands (positioned after the status) that are static for a run */
+    StaticDataCacheStatistics staticDataCacheStatistics;
+
+    /**
+     * returns whether the value of a variable is known not to change during a run (unless changed via this class, which invalidates the cache)
+     */
+    static bool isStaticVariable(uint8_t commandId, uint8_t variableId);
+
+    /**
+     * send a get variable command, returning the response from the static data cache if possible (see TraCIConnection::query)
+     */
+    TraCIBuffer queryVariable(uint8_t commandId, const std::string& objectId, uint8_t variableId, TraCIConnection::Result* result);
+
+    /**
+     * queue a get variable command, calling handler right away if its response is in the static data cache (see TraCIConnection::enqueue)
+     */
+    void enqueueVariable(uint8_t commandId, const std::string& objectId, uint8_t variableId, TraCIConnection::ResponseHandler handler);
+
     std::string genericGetString(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, TraCIConnection::Result* result = nullptr);
     Coord genericGetCoord(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, TraCIConnection::Result* result = nullptr);
     double genericGetDouble(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, TraCIConnection::Result* result = nullptr);
@@ -562,6 +628,16 @@ private:
     int32_t genericGetInt(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, TraCIConnection::Result* result = nullptr);
     std::list<std::string> genericGetStringList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, TraCIConnection::Result* result = nullptr);
     std::list<Coord> genericGetCoordList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, TraCIConnection::Result* result = nullptr);
+
+    // queued variants of the above, see TraCIConnection::enqueue
+    void genericGetString(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, std::function<void(std::string)> handler);
+    void genericGetCoord(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, std::function<void(Coord)> handler);
+    void genericGetCoordList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, std::function<void(std::list<Coord>)> handler);
+
+    /**
+     * read the header of a response to a get variable command, making sure it matches the command
+     */
+    static void readGetResponseHeader(TraCIBuffer& buf, uint8_t responseId, uint8_t variableId, const std::string& objectId, uint8_t resultTypeId);
 };
 
 } // namespace veins
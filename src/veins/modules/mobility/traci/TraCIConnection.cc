@@ -24,14 +24,17 @@
 #include <platdep/sockets.h>
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
 #include <ws2tcpip.h>
+#define VEINS_TRACI_NO_WRITEV
 #else
 #include <netinet/tcp.h>
 #include <netdb.h>
 #include <arpa/inet.h>
+#include <sys/uio.h>
 #endif
 
 #include <algorithm>
 #include <functional>
+#include <stdexcept>
 
 #include "veins/modules/mobility/traci/TraCIConnection.h"
 #include "veins/modules/mobility/traci/TraCIConstants.h"
@@ -74,15 +77,17 @@ TraCIConnection::Result::Result(bool success, bool not_impl, std::string message
 {
 }
 
-TraCIConnection::TraCIConnection(cComponent* owner, void* ptr)
+TraCIConnection::TraCIConnection(cComponent* owner, void* ptr, std::unique_ptr<TraCITraceReader> traceReader)
     : HasLogProxy(owner)
     , socketPtr(ptr)
+    , traceReader(std::move(traceReader))
 {
-    ASSERT(socketPtr);
+    ASSERT(socketPtr || this->traceReader);
 }
 
 TraCIConnection::~TraCIConnection()
 {
+    if (pendingQueryResponse.valid()) pendingQueryResponse.wait();
     if (socketPtr) {
         closesocket(socket(socketPtr));
         delete static_cast<SOCKET*>(socketPtr);
@@ -150,13 +155,120 @@ TraCIConnection* TraCIConnection::connect(cComponent* owner, const char* host, i
     return new TraCIConnection(owner, socketPtr);
 }
 
+TraCIConnection* TraCIConnection::replay(cComponent* owner, const std::string& traceFile)
+{
+    return new TraCIConnection(owner, nullptr, std::unique_ptr<TraCITraceReader>(new TraCITraceReader(traceFile)));
+}
+
+void TraCIConnection::startRecording(const std::string& traceFile)
+{
+    if (isReplaying()) throw cRuntimeError("Cannot record a TraCI trace while replaying one");
+    if (hasPendingQuery()) throw cRuntimeError("Cannot start recording a TraCI trace while the response to command 0x%2x is pending", pendingQueryCommandId);
+    traceWriter.reset(new TraCITraceWriter(traceFile));
+}
+
 TraCIBuffer TraCIConnection::query(uint8_t commandId, const TraCIBuffer& buf, Result* result)
 {
+    // keep commands in order
+    flush();
+
     sendMessage(makeTraCICommand(commandId, buf));
 
     TraCIBuffer obuf(receiveMessage());
+    readStatus(obuf, commandId, result);
+    return obuf;
+}
+
+void TraCIConnection::startQuery(uint8_t commandId, const TraCIBuffer& buf)
+{
+    if (hasPendingQuery()) throw cRuntimeError("Cannot start TraCI command 0x%2x while command 0x%2x is pending", commandId, pendingQueryCommandId);
+
+    // keep commands in order
+    flush();
+
+    sendMessage(makeTraCICommand(commandId, buf));
+
+    pendingQueryCommandId = commandId;
+    pendingQueryResponse = std::async(std::launch::async, [this]() { return readMessage(); });
+}
+
+TraCIBuffer TraCIConnection::finishQuery(Result* result)
+{
+    if (!hasPendingQuery()) throw cRuntimeError("No pending TraCI command to finish");
+    waitForPendingQuery();
+
+    uint8_t commandId = pendingQueryCommandId;
+    pendingQueryCommandId = 0;
+    TraCIBuffer obuf(std::move(pendingQueryMessage));
+    pendingQueryMessage.clear();
+    readStatus(obuf, commandId, result);
+    return obuf;
+}
+
+void TraCIConnection::waitForPendingQuery()
+{
+    if (!pendingQueryResponse.valid()) return;
+    try {
+        pendingQueryMessage = pendingQueryResponse.get();
+    }
+    catch (const std::runtime_error& e) {
+        throw cRuntimeError("%s", e.what());
+    }
+    EV_TRACE << "Read TraCI message of " << pendingQueryMessage.length() << " bytes in the background" << endl;
+}
+
+void TraCIConnection::enqueue(uint8_t commandId, const TraCIBuffer& buf, bool expectsResponse, ResponseHandler handler, Result* result)
+{
+    // the command would only be flushed after the pending one has been processed by the server
+    if (hasPendingQuery()) throw cRuntimeError("Cannot queue TraCI command 0x%2x while the response to command 0x%2x is pending", commandId, pendingQueryCommandId);
+    queuedMessage += makeTraCICommand(commandId, buf);
+    queuedCommands.push_back({commandId, expectsResponse, std::move(handler), result});
+}
+
+void TraCIConnection::flush()
+{
+    if (queuedCommands.empty()) return;
+
+    // take over the queue, so handlers can queue (and flush) new commands
+    std::vector<QueuedCommand> commands;
+    commands.swap(queuedCommands);
+    std::string message;
+    message.swap(queuedMessage);
+
+    EV_TRACE << "Sending " << commands.size() << " queued TraCI commands" << endl;
+    sendMessage(message);
+
+    TraCIBuffer obuf(receiveMessage());
+    for (auto& command : commands) {
+        readStatus(obuf, command.commandId, command.result);
+
+        // a failed command is answered by its status only
+        TraCIBuffer response;
+        if (command.expectsResponse && (command.result == nullptr || command.result->success)) {
+            uint32_t length = obuf.peek<uint8_t>();
+            size_t commandIdOffset = sizeof(uint8_t);
+            if (length == 0) {
+                length = obuf.peek<uint32_t>(sizeof(uint8_t));
+                commandIdOffset += sizeof(uint32_t);
+            }
+            uint8_t responseId = obuf.peek<uint8_t>(commandIdOffset);
+            if (responseId != static_cast<uint8_t>(command.commandId + 0x10)) throw cRuntimeError("Expected response to queued TraCI command 0x%2x, but received command 0x%2x", command.commandId, responseId);
+            response = obuf.readSubBuffer(length);
+        }
+
+        if (command.handler) command.handler(response);
+    }
+    if (!obuf.eof()) throw cRuntimeError("Received unexpected data in response to queued TraCI commands");
+}
+
+void TraCIConnection::readStatus(TraCIBuffer& obuf, uint8_t commandId, Result* result)
+{
     uint8_t cmdLength;
     obuf >> cmdLength;
+    if (cmdLength == 0) {
+        uint32_t cmdLengthX;
+        obuf >> cmdLengthX;
+    }
     uint8_t commandResp;
     obuf >> commandResp;
     ASSERT(commandResp == commandId);
@@ -173,92 +285,153 @@ TraCIBuffer TraCIConnection::query(uint8_t commandId, const TraCIBuffer& buf, Re
         if (resultCode == RTYPE_NOTIMPLEMENTED) throw cRuntimeError("TraCI server reported command 0x%2x not implemented (\"%s\"). Might need newer version.", commandId, description.c_str());
         if (resultCode != RTYPE_OK) throw cRuntimeError("TraCI server reported status %d executing command 0x%2x (\"%s\").", (int) resultCode, commandId, description.c_str());
     }
-    return obuf;
 }
 
 std::string TraCIConnection::receiveMessage()
 {
-    if (!socketPtr) throw cRuntimeError("Not connected to TraCI server");
+    if (!socketPtr && !traceReader) throw cRuntimeError("Not connected to TraCI server");
+    if (pendingQueryResponse.valid()) throw cRuntimeError("Cannot receive TraCI message while the response to command 0x%2x is pending", pendingQueryCommandId);
+
+    try {
+        std::string buf = readMessage();
+        EV_TRACE << "Read TraCI message of " << buf.length() << " bytes" << endl;
+        return buf;
+    }
+    catch (const std::runtime_error& e) {
+        throw cRuntimeError("%s", e.what());
+    }
+}
+
+std::string TraCIConnection::readMessage()
+{
+    if (traceReader) {
+        std::string buf = traceReader->read(TraCITrace::RECEIVED);
+        statistics.messagesReceived++;
+        statistics.bytesReceived += sizeof(uint32_t) + buf.length();
+        return buf;
+    }
 
     uint32_t msgLength;
     {
         char buf2[sizeof(uint32_t)];
-        uint32_t bytesRead = 0;
-        while (bytesRead < sizeof(uint32_t)) {
-            int receivedBytes = ::recv(socket(socketPtr), reinterpret_cast<char*>(&buf2) + bytesRead, sizeof(uint32_t) - bytesRead, 0);
-            if (receivedBytes > 0) {
-                bytesRead += receivedBytes;
-            }
-            else if (receivedBytes == 0) {
-                throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
-            }
-            else {
-                if (sock_errno() == EINTR) continue;
-                if (sock_errno() == EAGAIN) continue;
-                throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-            }
-        }
+        receiveAll(buf2, sizeof(uint32_t));
         TraCIBuffer(std::string(buf2, sizeof(uint32_t))) >> msgLength;
     }
+    if (msgLength < sizeof(msgLength)) throw std::runtime_error("Received malformed TraCI message (length " + std::to_string(msgLength) + ")");
 
     uint32_t bufLength = msgLength - sizeof(msgLength);
-    char buf[bufLength];
-    {
-        EV_TRACE << "Reading TraCI message of " << bufLength << " bytes" << endl;
-        uint32_t bytesRead = 0;
-        while (bytesRead < bufLength) {
-            int receivedBytes = ::recv(socket(socketPtr), reinterpret_cast<char*>(&buf) + bytesRead, bufLength - bytesRead, 0);
-            if (receivedBytes > 0) {
-                bytesRead += receivedBytes;
-            }
-            else if (receivedBytes == 0) {
-                throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
-            }
-            else {
-                if (sock_errno() == EINTR) continue;
-                if (sock_errno() == EAGAIN) continue;
-                throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-            }
+    std::string buf(bufLength, '\0');
+    if (bufLength > 0) receiveAll(&buf[0], bufLength);
+    statistics.messagesReceived++;
+    if (traceWriter) traceWriter->write(TraCITrace::RECEIVED, buf);
+    return buf;
+}
+
+void TraCIConnection::receiveAll(char* data, size_t size)
+{
+    size_t bytesRead = 0;
+    while (bytesRead < size) {
+        int receivedBytes = ::recv(socket(socketPtr), data + bytesRead, size - bytesRead, 0);
+        statistics.receiveCalls++;
+        if (receivedBytes > 0) {
+            bytesRead += receivedBytes;
+            statistics.bytesReceived += receivedBytes;
+        }
+        else if (receivedBytes == 0) {
+            throw std::runtime_error("Connection to TraCI server closed unexpectedly. Check your server's log");
+        }
+        else {
+            if (sock_errno() == EINTR) continue;
+            if (sock_errno() == EAGAIN) continue;
+            throw std::runtime_error("Connection to TraCI server lost. Check your server's log. Error message: " + std::to_string(sock_errno()) + ": " + strerror(sock_errno()));
         }
     }
-    return std::string(buf, bufLength);
 }
 
-void TraCIConnection::sendMessage(std::string buf)
+void TraCIConnection::sendMessage(const std::string& buf)
 {
-    if (!socketPtr) throw cRuntimeError("Not connected to TraCI server");
+    if (!socketPtr && !traceReader) throw cRuntimeError("Not connected to TraCI server");
 
-    {
-        uint32_t msgLength = sizeof(uint32_t) + buf.length();
-        TraCIBuffer buf2 = TraCIBuffer();
-        buf2 << msgLength;
-        uint32_t bytesWritten = 0;
-        while (bytesWritten < sizeof(uint32_t)) {
-            ssize_t sentBytes = ::send(socket(socketPtr), buf2.str().c_str() + bytesWritten, sizeof(uint32_t) - bytesWritten, 0);
-            if (sentBytes > 0) {
-                bytesWritten += sentBytes;
+    // the server would process this message after the pending command, i.e., in a different state than expected by the caller
+    if (hasPendingQuery()) throw cRuntimeError("Cannot send TraCI command 0x%2x while the response to command 0x%2x is pending", TraCITrace::getFirstCommandId(buf), pendingQueryCommandId);
+
+    if (traceReader) {
+        size_t stepsRead = traceReader->getNumStepsRead();
+        std::string expected;
+        try {
+            expected = traceReader->read(TraCITrace::SENT);
+        }
+        catch (const std::runtime_error& e) {
+            throw cRuntimeError("Cannot replay TraCI message starting with command 0x%2x: %s", TraCITrace::getFirstCommandId(buf), e.what());
+        }
+        if (buf != expected) {
+            throw cRuntimeError("TraCI message starting with command 0x%2x differs from the one sent after %zu simulation steps of the replayed trace (command 0x%2x). "
+                                "Replaying only works with the configuration the trace was recorded with, and without any commands that change the state of the TraCI server.",
+                TraCITrace::getFirstCommandId(buf), stepsRead, TraCITrace::getFirstCommandId(expected));
+        }
+        EV_TRACE << "Replayed TraCI message of " << buf.length() << " bytes" << endl;
+        statistics.messagesSent++;
+        statistics.bytesSent += sizeof(uint32_t) + buf.length();
+        return;
+    }
+    if (traceWriter) traceWriter->write(TraCITrace::SENT, buf);
+
+    uint32_t msgLength = sizeof(uint32_t) + buf.length();
+    std::string header = (TraCIBuffer() << msgLength).str();
+
+    EV_TRACE << "Writing TraCI message of " << buf.length() << " bytes" << endl;
+#ifndef VEINS_TRACI_NO_WRITEV
+    // send header and message in one go, continuing after partial writes
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<char*>(header.data());
+    iov[0].iov_len = header.length();
+    iov[1].iov_base = const_cast<char*>(buf.data());
+    iov[1].iov_len = buf.length();
+    struct iovec* pending = iov;
+    int numPending = 2;
+    while (numPending > 0) {
+        ssize_t sentBytes = ::writev(socket(socketPtr), pending, numPending);
+        statistics.sendCalls++;
+        if (sentBytes > 0) {
+            statistics.bytesSent += sentBytes;
+            size_t remaining = sentBytes;
+            while ((numPending > 0) && (remaining >= pending->iov_len)) {
+                remaining -= pending->iov_len;
+                ++pending;
+                --numPending;
             }
-            else {
-                if (sock_errno() == EINTR) continue;
-                if (sock_errno() == EAGAIN) continue;
-                throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
+            if (numPending > 0) {
+                pending->iov_base = static_cast<char*>(pending->iov_base) + remaining;
+                pending->iov_len -= remaining;
             }
         }
+        else {
+            if (sock_errno() == EINTR) continue;
+            if (sock_errno() == EAGAIN) continue;
+            throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
+        }
     }
+#else
+    std::string msg = header + buf;
+    sendAll(msg.data(), msg.length());
+#endif
+    statistics.messagesSent++;
+}
 
-    {
-        EV_TRACE << "Writing TraCI message of " << buf.length() << " bytes" << endl;
-        uint32_t bytesWritten = 0;
-        while (bytesWritten < buf.length()) {
-            ssize_t sentBytes = ::send(socket(socketPtr), buf.c_str() + bytesWritten, buf.length() - bytesWritten, 0);
-            if (sentBytes > 0) {
-                bytesWritten += sentBytes;
-            }
-            else {
-                if (sock_errno() == EINTR) continue;
-                if (sock_errno() == EAGAIN) continue;
-                throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-            }
+void TraCIConnection::sendAll(const char* data, size_t size)
+{
+    size_t bytesWritten = 0;
+    while (bytesWritten < size) {
+        ssize_t sentBytes = ::send(socket(socketPtr), data + bytesWritten, size - bytesWritten, 0);
+        statistics.sendCalls++;
+        if (sentBytes > 0) {
+            bytesWritten += sentBytes;
+            statistics.bytesSent += sentBytes;
+        }
+        else {
+            if (sock_errno() == EINTR) continue;
+            if (sock_errno() == EAGAIN) continue;
+            throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
         }
     }
 }
@@ -23,11 +23,15 @@
 #pragma once
 
 #include <stdint.h>
+#include <functional>
+#include <future>
 #include <memory>
+#include <vector>
 
 #include "veins/modules/mobility/traci/TraCIBuffer.h"
 #include "veins/modules/mobility/traci/TraCICoord.h"
 #include "veins/modules/mobility/traci/TraCICoordinateTransformation.h"
+#include "veins/modules/mobility/traci/TraCITrace.h"
 #include "veins/base/utils/Coord.h"
 #include "veins/base/utils/Heading.h"
 #include "veins/modules/utility/HasLogProxy.h"
@@ -46,7 +50,25 @@ public:
         std::string message;
     };
 
+    /**
+     * counters for data exchanged with the TraCI server
+     */
+    struct VEINS_API Statistics {
+        uint64_t messagesSent = 0;
+        uint64_t messagesReceived = 0;
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t sendCalls = 0; /**< number of send (or writev) system calls */
+        uint64_t receiveCalls = 0; /**< number of recv system calls */
+    };
+
     static TraCIConnection* connect(cComponent* owner, const char* host, int port);
+
+    /**
+     * returns a connection that replays a trace written by startRecording instead of talking to a TraCI server.
+     * Every message sent must be identical to the next one sent in the trace (else a cRuntimeError is thrown), and is answered with the message received in the trace.
+     */
+    static TraCIConnection* replay(cComponent* owner, const std::string& traceFile);
     void setNetbounds(TraCICoord netbounds1, TraCICoord netbounds2, int margin);
     ~TraCIConnection();
 
@@ -59,15 +81,87 @@ public:
     TraCIBuffer query(uint8_t commandId, const TraCIBuffer& buf = TraCIBuffer(), Result* result = nullptr);
 
     /**
-     * sends a message via TraCI (after adding the header)
+     * handles the response to a queued command, which is passed in the same format as returned by query (empty if the command has no response)
+     */
+    typedef std::function<void(TraCIBuffer& response)> ResponseHandler;
+
+    /**
+     * queues a command to be sent together with all other queued commands in a single message, on the next call to flush (or query).
+     * Only commands that are answered with a status and, optionally, a response command with id commandId + 0x10 can be queued (e.g., get variable or subscribe variable commands, but not simulation steps).
+     * @param commandId: command to send
+     * @param buf: additional parameters to send
+     * @param expectsResponse: whether a successful status is followed by a response command (true for get variable and subscribe commands, false for set commands, subscription filters, and unsubscribing)
+     * @param handler: called once the response has been received (if set)
+     * @param result: as for query, must stay valid until the command has been flushed
+     */
+    void enqueue(uint8_t commandId, const TraCIBuffer& buf, bool expectsResponse, ResponseHandler handler = ResponseHandler(), Result* result = nullptr);
+
+    /**
+     * sends all queued commands in a single message, then calls their response handlers in the order they were queued
+     */
+    void flush();
+
+    /**
+     * sends a single command via TraCI, but receives its response on a background thread, so the caller can continue until it calls finishQuery.
+     * The server processes any other command only after this one, so sending or queueing one before finishQuery throws a cRuntimeError instead of silently changing its effect.
+     */
+    void startQuery(uint8_t commandId, const TraCIBuffer& buf = TraCIBuffer());
+
+    /**
+     * waits for the response to the command sent by startQuery, checks its status, and returns additional responses (like query)
      */
-    void sendMessage(std::string buf);
+    TraCIBuffer finishQuery(Result* result = nullptr);
+
+    /**
+     * returns whether a command sent by startQuery has not been finished yet
+     */
+    bool hasPendingQuery() const
+    {
+        return pendingQueryCommandId != 0;
+    }
+
+    /**
+     * sends a message via TraCI (after adding the header), using a single system call where possible
+     */
+    void sendMessage(const std::string& buf);
 
     /**
      * receives a message via TraCI (and strips the header)
+     *
+     * The message is received directly into the returned string, so it can be moved into a TraCIBuffer without copying.
      */
     std::string receiveMessage();
 
+    /**
+     * writes all messages exchanged from now on to a trace file (see TraCITrace), for use with replay
+     */
+    void startRecording(const std::string& traceFile);
+
+    /**
+     * returns whether this connection replays a trace (see replay)
+     */
+    bool isReplaying() const
+    {
+        return traceReader != nullptr;
+    }
+
+    /**
+     * returns the trace this connection replays (see replay)
+     */
+    const TraCITraceReader& getReplayedTrace() const
+    {
+        ASSERT(isReplaying());
+        return *traceReader;
+    }
+
+    /**
+     * returns counters for data exchanged with the TraCI server so far
+     */
+    const Statistics& getStatistics() const
+    {
+        return statistics;
+    }
+
     /**
      * convert TraCI heading to OMNeT++ heading (in rad)
      */
@@ -91,9 +185,49 @@ public:
     std::list<TraCICoord> omnet2traci(const std::list<Coord>&) const;
 
 private:
-    TraCIConnection(cComponent* owner, void* ptr);
+    TraCIConnection(cComponent* owner, void* ptr, std::unique_ptr<TraCITraceReader> traceReader = nullptr);
+
+    /**
+     * receives a message (like receiveMessage), but throws std::runtime_error instead of cRuntimeError and does not log, so it can be used from a background thread
+     */
+    std::string readMessage();
+
+    /**
+     * receives exactly size bytes, throwing std::runtime_error on errors (see readMessage)
+     */
+    void receiveAll(char* data, size_t size);
+
+    /**
+     * waits for the response to the command sent by startQuery (if any)
+     */
+    void waitForPendingQuery();
+
+    /**
+     * sends exactly size bytes
+     */
+    void sendAll(const char* data, size_t size);
+
+    /**
+     * reads the status response to commandId, storing it in result (or throwing on errors if result is nullptr)
+     */
+    void readStatus(TraCIBuffer& obuf, uint8_t commandId, Result* result);
+
+    struct QueuedCommand {
+        uint8_t commandId;
+        bool expectsResponse;
+        ResponseHandler handler;
+        Result* result;
+    };
 
     void* socketPtr;
+    Statistics statistics;
+    std::vector<QueuedCommand> queuedCommands; /**< commands waiting for the next call to flush */
+    std::string queuedMessage; /**< queued commands, ready to send */
+    uint8_t pendingQueryCommandId = 0; /**< command sent by startQuery and not finished yet (0 if none) */
+    std::future<std::string> pendingQueryResponse; /**< response to the command sent by startQuery, until it has been received */
+    std::string pendingQueryMessage; /**< response to the command sent by startQuery, once it has been received */
+    std::unique_ptr<TraCITraceWriter> traceWriter; /**< trace to record all messages to, if any */
+    std::unique_ptr<TraCITraceReader> traceReader; /**< trace to replay instead of talking to a TraCI server, if any */
     std::unique_ptr<TraCICoordinateTransformation> coordinateTransformation;
 };
 
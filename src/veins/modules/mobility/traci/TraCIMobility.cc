@@ -84,6 +84,7 @@ void TraCIMobility::initialize(int stage)
 
         statistics.initialize();
         statistics.watch(*this);
+        vehicleStartTime = simTime();
 
         ASSERT(isPreInitialized);
         isPreInitialized = false;
@@ -122,7 +123,8 @@ void TraCIMobility::initialize(int stage)
 
 void TraCIMobility::finish()
 {
-    statistics.stopTime = simTime();
+    // a parked module (see RecyclableModule) stopped with its last vehicle
+    if (external_id != "") statistics.stopTime = simTime();
 
     statistics.recordScalars(*this);
 
@@ -132,6 +134,36 @@ void TraCIMobility::finish()
     isPreInitialized = false;
 }
 
+void TraCIMobility::prepareForRecycling()
+{
+    BaseMobility::prepareForRecycling();
+
+    statistics.stopTime = simTime();
+
+    cancelAndDelete(startAccidentMsg);
+    startAccidentMsg = nullptr;
+    cancelAndDelete(stopAccidentMsg);
+    stopAccidentMsg = nullptr;
+
+    delete vehicleCommandInterface;
+    vehicleCommandInterface = nullptr;
+    commandInterface = nullptr;
+
+    external_id = "";
+    road_id = "";
+    speed = -1;
+    heading = Heading::nan;
+    signals = {VehicleSignal::undefined};
+}
+
+void TraCIMobility::reinitialize(int stage)
+{
+    // all remaining state is reset by initialize and preInitialize, but statistics are kept for all vehicles
+    Statistics previousStatistics = statistics;
+    initialize(stage);
+    statistics = previousStatistics;
+}
+
 void TraCIMobility::handleSelfMsg(cMessage* msg)
 {
     if (msg == startAccidentMsg) {
@@ -200,7 +232,7 @@ void TraCIMobility::changePosition()
     currentPosYVec.record(nextPos.y);
 
     // keep statistics (relative to last step)
-    if (statistics.startTime != simTime()) {
+    if (vehicleStartTime != simTime()) {
         simtime_t updateInterval = simTime() - this->lastUpdate;
 
         double distance = move.getStartPos().distance(nextPos);
@@ -31,6 +31,7 @@
 #include "veins/base/utils/FindModule.h"
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/modules/mobility/traci/TraCICommandInterface.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/modules/mobility/traci/VehicleSignal.h"
 #include "veins/base/utils/Heading.h"
 
@@ -56,7 +57,7 @@ namespace veins {
  *
  * @ingroup mobility
  */
-class VEINS_API TraCIMobility : public BaseMobility {
+class VEINS_API TraCIMobility : public BaseMobility, public RecyclableModule {
 public:
     class VEINS_API Statistics {
     public:
@@ -93,6 +94,13 @@ public:
     void finish() override;
 
     void handleSelfMsg(cMessage* msg) override;
+
+    void prepareForRecycling() override;
+    void reinitialize(int stage) override;
+    int numReinitStages() const override
+    {
+        return numInitStages();
+    }
     virtual void preInitialize(std::string external_id, const Coord& position, std::string road_id = "", double speed = -1, Heading heading = Heading::nan);
     virtual void nextPosition(const Coord& position, std::string road_id = "", double speed = -1, Heading heading = Heading::nan, VehicleSignalSet signals = {VehicleSignal::undefined});
     virtual void changePosition();
@@ -172,6 +180,7 @@ protected:
     cOutVector currentCO2EmissionVec; /**< vector plotting current CO2 emission */
 
     Statistics statistics; /**< everything statistics-related */
+    simtime_t vehicleStartTime; /**< time the current vehicle was added (statistics.startTime is that of the first vehicle, see RecyclableModule) */
 
     bool isPreInitialized; /**< true if preInitialize() has been called immediately before initialize() */
 
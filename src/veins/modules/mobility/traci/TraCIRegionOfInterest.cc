@@ -105,6 +105,11 @@ bool TraCIRegionOfInterest::hasConstraints() const
     return !roiRoads.empty() || !roiRects.empty();
 }
 
+bool TraCIRegionOfInterest::hasRoads() const
+{
+    return !roiRoads.empty();
+}
+
 const std::list<std::pair<TraCICoord, TraCICoord>>& TraCIRegionOfInterest::getRectangles() const
 {
     return roiRects;
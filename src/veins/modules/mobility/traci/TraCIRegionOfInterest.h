@@ -82,6 +82,12 @@ public:
      */
     bool hasConstraints() const;
 
+    /**
+     * Check if any roads are part of the constraints
+     * @return true if ROI roads exist
+     */
+    bool hasRoads() const;
+
     const std::list<std::pair<TraCICoord, TraCICoord>>& getRectangles() const;
 
 private:
@@ -20,25 +20,32 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <chrono>
 #include <fstream>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
 #include <iterator>
 #include <cstdlib>
+#include <cmath>
+#include <typeinfo>
+#include <unordered_set>
 
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
 #include "veins/modules/mobility/traci/TraCICommandInterface.h"
 #include "veins/modules/mobility/traci/TraCIConstants.h"
 #include "veins/modules/mobility/traci/TraCIMobility.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/modules/obstacle/ObstacleControl.h"
 #include "veins/modules/world/traci/trafficLight/TraCITrafficLightInterface.h"
 
 using namespace veins::TraCIConstants;
 
 using veins::AnnotationManagerAccess;
+using veins::RecyclableModule;
 using veins::TraCIBuffer;
+using veins::TraCIConnection;
 using veins::TraCICoord;
 using veins::TraCIScenarioManager;
 using veins::TraCITrafficLightInterface;
@@ -63,7 +70,9 @@ TraCIScenarioManager::TraCIScenarioManager()
 
 TraCIScenarioManager::~TraCIScenarioManager()
 {
-    if (connection) {
+    // a replayed trace need not end with the simulation, so do not risk a mismatch here
+    if (connection && !connection->isReplaying()) {
+        if (connection->hasPendingQuery()) connection->finishQuery();
         TraCIBuffer buf = connection->query(CMD_CLOSE, TraCIBuffer());
     }
     if (connectAndStartTrigger) {
@@ -256,8 +265,21 @@ void TraCIScenarioManager::initialize(int stage)
     if (firstStepAt == -1) firstStepAt = connectAt + updateInterval;
     parseModuleTypes();
     penetrationRate = par("penetrationRate").doubleValue();
+    unsubscribeUnequippedVehicles = par("unsubscribeUnequippedVehicles");
+    useContextSubscriptions = par("useContextSubscriptions");
+    pipelineSimulationSteps = par("pipelineSimulationSteps");
+    cacheStaticData = par("cacheStaticData");
+    recycleVehicleModules = par("recycleVehicleModules");
+    pipelinedSteps = 0;
+    {
+        cStringTokenizer tokenizer(par("contextSubscriptionVehicleTypes").stringValue());
+        std::vector<std::string> types = tokenizer.asVector();
+        contextSubscriptionVehicleTypes.assign(types.begin(), types.end());
+    }
     ignoreGuiCommands = par("ignoreGuiCommands");
     host = par("host").stdstringValue();
+    polygonFile = par("polygonFile").stdstringValue();
+    recordTraceFile = par("recordTraceFile").stdstringValue();
     port = getPortNumber();
     if (port == -1) {
         throw cRuntimeError("TraCI Port autoconfiguration failed, set 'port' != -1 in omnetpp.ini or provide VEINS_TRACI_PORT environment variable.");
@@ -269,11 +291,19 @@ void TraCIScenarioManager::initialize(int stage)
     roi.clear();
     roi.addRoads(par("roiRoads"));
     roi.addRectangles(par("roiRects"));
+    if (useContextSubscriptions && (roi.getRectangles().empty() || roi.hasRoads())) {
+        throw cRuntimeError("useContextSubscriptions requires the region of interest to be given as roiRects (and not roiRoads)");
+    }
 
     areaSum = 0;
     nextNodeVectorIndex = 0;
     hosts.clear();
-    subscribedVehicles.clear();
+    vehicleIndices.clear();
+    vehicles.clear();
+    freeVehicleIndices.clear();
+    unequippedVehicleCount = 0;
+    vehicleReportGeneration = 0;
+    contextVehicles.clear();
     trafficLights.clear();
     activeVehicleCount = 0;
     parkingVehicleCount = 0;
@@ -293,8 +323,16 @@ void TraCIScenarioManager::initialize(int stage)
     EV_DEBUG << "initialized TraCIScenarioManager" << endl;
 }
 
+TraCIConnection* TraCIScenarioManager::createConnection()
+{
+    return TraCIConnection::connect(this, host.c_str(), port);
+}
+
 void TraCIScenarioManager::init_traci()
 {
+    // messages exchanged before (e.g., with a launchd) are specific to how the server was started, so leave them out
+    if (!recordTraceFile.empty()) connection->startRecording(recordTraceFile);
+
     auto* commandInterface = getCommandInterface();
     {
         auto apiVersion = commandInterface->getVersion();
@@ -338,7 +376,19 @@ void TraCIScenarioManager::init_traci()
         ASSERT(buf.eof());
     }
 
-    {
+    if (useContextSubscriptions) {
+        // subscribe to vehicles around an (invisible) point of interest at the center of each ROI rectangle
+        int n = 0;
+        for (const auto& rect : roi.getRectangles()) {
+            TraCICoord center((rect.first.x + rect.second.x) / 2, (rect.first.y + rect.second.y) / 2);
+            double range = 0.5 * std::sqrt(std::pow(rect.second.x - rect.first.x, 2) + std::pow(rect.second.y - rect.first.y, 2));
+            std::string poiId = "veins.roi." + std::to_string(n++);
+            commandInterface->addPoi(poiId, "veins.roi", TraCIColor(0, 0, 0, 0), 0, connection->traci2omnet(center));
+            subscribeToVehicleContext(poiId, range);
+        }
+        connection->flush();
+    }
+    else {
         // subscribe to list of vehicle ids
         simtime_t beginTime = 0;
         simtime_t endTime = SimTime::getMaxTime();
@@ -361,6 +411,15 @@ void TraCIScenarioManager::init_traci()
         // query traffic lights via TraCI
         std::list<std::string> trafficLightIds = commandInterface->getTrafficlightIds();
         size_t nrOfTrafficLights = trafficLightIds.size();
+
+        // get positions of all selected traffic lights at once
+        std::map<std::string, Coord> positions;
+        for (auto& tlId : trafficLightIds) {
+            if (std::find(trafficLightModuleIds.begin(), trafficLightModuleIds.end(), tlId) == trafficLightModuleIds.end()) continue;
+            commandInterface->junction(tlId).getPosition([&positions, tlId](Coord position) { positions[tlId] = position; });
+        }
+        connection->flush();
+
         int cnt = 0;
         for (std::list<std::string>::iterator i = trafficLightIds.begin(); i != trafficLightIds.end(); ++i) {
             std::string tlId = *i;
@@ -368,7 +427,7 @@ void TraCIScenarioManager::init_traci()
                 continue; // filter only selected elements
             }
 
-            Coord position = commandInterface->junction(tlId).getPosition();
+            Coord position = positions[tlId];
 
             cModule* module = tlModuleType->create(trafficLightModuleName.c_str(), parentmod, nrOfTrafficLights, cnt);
             module->par("externalId") = tlId;
@@ -393,27 +452,38 @@ void TraCIScenarioManager::init_traci()
             subscribeToTrafficLightVariables(tlId); // subscribe after module is in trafficLights
             cnt++;
         }
+        connection->flush();
     }
 
     ObstacleControl* obstacles = ObstacleControlAccess().getIfExists();
-    if (obstacles) {
+    if (obstacles && !polygonFile.empty()) {
+        // read polygons directly from file, which is much faster than querying them one by one
+        obstacles->addFromPolygonFile(polygonFile, [this](const Coord& c) { return connection->traci2omnet(TraCICoord(c.x, c.y)); });
+    }
+    else if (obstacles) {
         {
-            // get list of polygons
+            // get list of polygons, then types of all polygons and shapes of supported ones (each in a single message)
             std::list<std::string> ids = commandInterface->getPolygonIds();
-            for (std::list<std::string>::iterator i = ids.begin(); i != ids.end(); ++i) {
-                std::string id = *i;
-                std::string typeId = commandInterface->polygon(id).getTypeId();
+            std::map<std::string, std::string> typeIds;
+            for (auto& id : ids) {
+                commandInterface->polygon(id).getTypeId([&typeIds, id](std::string typeId) { typeIds[id] = typeId; });
+            }
+            connection->flush();
+            for (auto& id : ids) {
+                std::string typeId = typeIds[id];
                 if (!obstacles->isTypeSupported(typeId)) continue;
-                std::list<Coord> coords = commandInterface->polygon(id).getShape();
-                std::vector<Coord> shape;
-                std::copy(coords.begin(), coords.end(), std::back_inserter(shape));
-                for (auto p : shape) {
-                    if ((p.x < 0) || (p.y < 0) || (p.x > world->getPgs()->x) || (p.y > world->getPgs()->y)) {
-                        EV_WARN << "WARNING: Playground (" << world->getPgs()->x << ", " << world->getPgs()->y << ") will not fit radio obstacle at (" << p.x << ", " << p.y << ")" << endl;
+                commandInterface->polygon(id).getShape([this, obstacles, id, typeId](std::list<Coord> coords) {
+                    std::vector<Coord> shape;
+                    std::copy(coords.begin(), coords.end(), std::back_inserter(shape));
+                    for (auto p : shape) {
+                        if ((p.x < 0) || (p.y < 0) || (p.x > world->getPgs()->x) || (p.y > world->getPgs()->y)) {
+                            EV_WARN << "WARNING: Playground (" << world->getPgs()->x << ", " << world->getPgs()->y << ") will not fit radio obstacle at (" << p.x << ", " << p.y << ")" << endl;
+                        }
                     }
-                }
-                obstacles->addFromTypeAndShape(id, typeId, shape);
+                    obstacles->addFromTypeAndShape(id, typeId, shape);
+                });
             }
+            connection->flush();
         }
     }
 
@@ -453,10 +523,62 @@ void TraCIScenarioManager::init_traci()
 void TraCIScenarioManager::finish()
 {
     while (hosts.begin() != hosts.end()) {
-        deleteManagedModule(hosts.begin()->first);
+        // copy the id, as deleteManagedModule erases the entry holding it
+        const std::string nodeId = hosts.begin()->first;
+        deleteManagedModule(nodeId);
     }
 
     recordScalar("roiArea", areaSum);
+
+    if (recycleVehicleModules) {
+        long created = 0;
+        long recycled = 0;
+        double constructionTime = 0;
+        double constructionTimeSaved = 0;
+        for (auto& i : modulePools) {
+            ModulePool& pool = i.second;
+            created += pool.created;
+            recycled += pool.recycled;
+            constructionTime += pool.constructionTime;
+            // estimate from the mean time it took to construct a module of this type
+            if (pool.created > 0) constructionTimeSaved += pool.recycled * pool.constructionTime / pool.created;
+
+            // parked modules record the results of all their vehicles now
+            for (auto mod : pool.parked) {
+                mod->callFinish();
+                mod->deleteModule();
+            }
+            pool.parked.clear();
+        }
+        for (auto mod : parkingModules) {
+            mod->callFinish();
+            mod->deleteModule();
+        }
+        parkingModules.clear();
+        recordScalar("traciModulesCreated", created);
+        recordScalar("traciModulesRecycled", recycled);
+        recordScalar("traciModuleConstructionTime", constructionTime);
+        recordScalar("traciModuleConstructionTimeSaved", constructionTimeSaved);
+    }
+
+    recordScalar("traciPipelinedSteps", pipelinedSteps);
+
+    if (connection) {
+        if (connection->hasPendingQuery()) connection->finishQuery();
+        const TraCIConnection::Statistics& statistics = connection->getStatistics();
+        recordScalar("traciMessagesSent", statistics.messagesSent);
+        recordScalar("traciMessagesReceived", statistics.messagesReceived);
+        recordScalar("traciBytesSent", statistics.bytesSent);
+        recordScalar("traciBytesReceived", statistics.bytesReceived);
+        recordScalar("traciSendCalls", statistics.sendCalls);
+        recordScalar("traciReceiveCalls", statistics.receiveCalls);
+    }
+
+    if (commandIfc && cacheStaticData) {
+        const TraCICommandInterface::StaticDataCacheStatistics& statistics = commandIfc->getStaticDataCacheStatistics();
+        recordScalar("traciStaticDataCacheHits", statistics.hits);
+        recordScalar("traciStaticDataCacheMisses", statistics.misses);
+    }
 }
 
 void TraCIScenarioManager::handleMessage(cMessage* msg)
@@ -471,8 +593,9 @@ void TraCIScenarioManager::handleMessage(cMessage* msg)
 void TraCIScenarioManager::handleSelfMsg(cMessage* msg)
 {
     if (msg == connectAndStartTrigger) {
-        connection.reset(TraCIConnection::connect(this, host.c_str(), port));
+        connection.reset(createConnection());
         commandIfc.reset(new TraCICommandInterface(this, *connection, ignoreGuiCommands));
+        commandIfc->setStaticDataCacheEnabled(cacheStaticData);
         init_traci();
         return;
     }
@@ -505,39 +628,74 @@ void TraCIScenarioManager::updateModulePosition(cModule* mod, const Coord& p, co
 void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::string name, std::string displayString, const Coord& position, std::string road_id, double speed, Heading heading, VehicleSignalSet signals, double length, double height, double width)
 {
 
-    if (hosts.find(nodeId) != hosts.end()) throw cRuntimeError("tried adding duplicate module");
+    uint32_t index = internVehicleId(nodeId);
+    if (vehicles[index].module) throw cRuntimeError("tried adding duplicate module");
 
-    double option1 = hosts.size() / (hosts.size() + unEquippedHosts.size() + 1.0);
-    double option2 = (hosts.size() + 1) / (hosts.size() + unEquippedHosts.size() + 1.0);
+    double option1 = hosts.size() / (hosts.size() + unequippedVehicleCount + 1.0);
+    double option2 = (hosts.size() + 1) / (hosts.size() + unequippedVehicleCount + 1.0);
 
     if (fabs(option1 - penetrationRate) < fabs(option2 - penetrationRate)) {
-        unEquippedHosts.insert(nodeId);
+        vehicles[index].unequipped = true;
+        unequippedVehicleCount++;
+        // stop receiving updates (the vehicle stays subscribed in our books, so it is not subscribed to again)
+        if (unsubscribeUnequippedVehicles && vehicles[index].subscribed && !vehicles[index].variablesUnsubscribed) {
+            vehicles[index].variablesUnsubscribed = true;
+            unsubscribeFromVehicleVariables(nodeId);
+        }
         return;
     }
 
-    int32_t nodeVectorIndex = nextNodeVectorIndex++;
-
     cModule* parentmod = getParentModule();
     if (!parentmod) throw cRuntimeError("Parent Module not found");
 
     cModuleType* nodeType = cModuleType::get(type.c_str());
     if (!nodeType) throw cRuntimeError("Module Type \"%s\" not found", type.c_str());
 
-    // TODO: this trashes the vectsize member of the cModule, although nobody seems to use it
-    cModule* mod = nodeType->create(name.c_str(), parentmod, nodeVectorIndex, nodeVectorIndex);
-    mod->finalizeParameters();
-    if (displayString.length() > 0) {
-        mod->getDisplayString().parse(displayString.c_str());
+    ModulePool& pool = modulePools[std::make_pair(std::string(nodeType->getFullName()), name)];
+
+    // modules parked in this time step can only be re-used once no more messages are on their way to them
+    if (pool.parked.empty() && !parkingModules.empty()) finishParking();
+
+    cModule* mod = nullptr;
+    bool recycled = !pool.parked.empty();
+    if (recycled) {
+        mod = pool.parked.back();
+        pool.parked.pop_back();
+        pool.recycled++;
+        if (displayString.length() > 0) {
+            mod->getDisplayString().parse(displayString.c_str());
+        }
+    }
+    else {
+        int32_t nodeVectorIndex = nextNodeVectorIndex++;
+
+        auto constructionStart = std::chrono::steady_clock::now();
+
+        // TODO: this trashes the vectsize member of the cModule, although nobody seems to use it
+        mod = nodeType->create(name.c_str(), parentmod, nodeVectorIndex, nodeVectorIndex);
+        mod->finalizeParameters();
+        if (displayString.length() > 0) {
+            mod->getDisplayString().parse(displayString.c_str());
+        }
+        mod->buildInside();
+        mod->scheduleStart(simTime() + updateInterval);
+
+        pool.created++;
+        pool.constructionTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - constructionStart).count();
     }
-    mod->buildInside();
-    mod->scheduleStart(simTime() + updateInterval);
 
     preInitializeModule(mod, nodeId, position, road_id, speed, heading, signals);
 
     emit(traciModulePreInitSignal, mod);
 
-    mod->callInitialize();
+    if (recycled) {
+        reinitializeModule(mod);
+    }
+    else {
+        mod->callInitialize();
+    }
     hosts[nodeId] = mod;
+    vehicles[index].module = mod;
 
     // post-initialize TraCIMobility
     auto mobilityModules = getSubmodulesOfType<TraCIMobility>(mod);
@@ -554,27 +712,65 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
         auto mm = mobilityModules[0];
         double offset = mm->getHostPositionOffset();
         const MobileHostObstacle* vo = vehicleObstacleControl->add(MobileHostObstacle(initialAntennaPositions, mm, length, offset, width, height));
-        vehicleObstacles[mm] = vo;
+        vehicles[index].obstacle = vo;
     }
 
     emit(traciModuleAddedSignal, mod);
 }
 
-cModule* TraCIScenarioManager::getManagedModule(std::string nodeId)
+cModule* TraCIScenarioManager::getManagedModule(const std::string& nodeId)
 {
-    if (hosts.find(nodeId) == hosts.end()) return nullptr;
-    return hosts[nodeId];
+    uint32_t index = findVehicleIndex(nodeId);
+    if (index == noVehicleIndex) return nullptr;
+    return vehicles[index].module;
 }
 
-bool TraCIScenarioManager::isModuleUnequipped(std::string nodeId)
+bool TraCIScenarioManager::isModuleUnequipped(const std::string& nodeId)
 {
-    if (unEquippedHosts.find(nodeId) == unEquippedHosts.end()) return false;
-    return true;
+    uint32_t index = findVehicleIndex(nodeId);
+    if (index == noVehicleIndex) return false;
+    return vehicles[index].unequipped;
 }
 
-void TraCIScenarioManager::deleteManagedModule(std::string nodeId)
+uint32_t TraCIScenarioManager::internVehicleId(const std::string& vehicleId)
 {
-    cModule* mod = getManagedModule(nodeId);
+    auto i = vehicleIndices.find(vehicleId);
+    if (i != vehicleIndices.end()) return i->second;
+
+    uint32_t index;
+    if (!freeVehicleIndices.empty()) {
+        index = freeVehicleIndices.back();
+        freeVehicleIndices.pop_back();
+    }
+    else {
+        index = vehicles.size();
+        vehicles.emplace_back();
+    }
+    vehicles[index].id = vehicleId;
+    vehicleIndices.emplace(vehicleId, index);
+    return index;
+}
+
+uint32_t TraCIScenarioManager::findVehicleIndex(const std::string& vehicleId) const
+{
+    auto i = vehicleIndices.find(vehicleId);
+    if (i == vehicleIndices.end()) return noVehicleIndex;
+    return i->second;
+}
+
+void TraCIScenarioManager::releaseVehicle(uint32_t index)
+{
+    VehicleState& state = vehicles[index];
+    if (state.id.empty() || state.module || state.subscribed || state.unequipped || (state.lastReported == vehicleReportGeneration)) return;
+    vehicleIndices.erase(state.id);
+    state = VehicleState();
+    freeVehicleIndices.push_back(index);
+}
+
+void TraCIScenarioManager::deleteManagedModule(const std::string& nodeId)
+{
+    uint32_t index = findVehicleIndex(nodeId);
+    cModule* mod = (index == noVehicleIndex) ? nullptr : vehicles[index].module;
     if (!mod) throw cRuntimeError("no vehicle with Id \"%s\" found", nodeId.c_str());
 
     emit(traciModuleRemovedSignal, mod);
@@ -586,19 +782,89 @@ void TraCIScenarioManager::deleteManagedModule(std::string nodeId)
         connectionManager->unregisterNic(nic);
     }
     if (vehicleObstacleControl) {
-        for (cModule::SubmoduleIterator iter(mod); !iter.end(); iter++) {
-            cModule* submod = *iter;
-            TraCIMobility* mm = dynamic_cast<TraCIMobility*>(submod);
-            if (!mm) continue;
-            auto vo = vehicleObstacles.find(mm);
-            ASSERT(vo != vehicleObstacles.end());
-            vehicleObstacleControl->erase(vo->second);
-        }
+        ASSERT(vehicles[index].obstacle);
+        vehicleObstacleControl->erase(vehicles[index].obstacle);
+        vehicles[index].obstacle = nullptr;
     }
 
     hosts.erase(nodeId);
-    mod->callFinish();
-    mod->deleteModule();
+    vehicles[index].module = nullptr;
+    if (recycleVehicleModules && isRecyclable(mod)) {
+        // finish is only called once the module is deleted, so it records the results of all vehicles it was used for
+        parkModule(mod);
+    }
+    else {
+        mod->callFinish();
+        mod->deleteModule();
+    }
+}
+
+bool TraCIScenarioManager::isRecyclable(cModule* mod)
+{
+    ModulePool& pool = modulePools[std::make_pair(std::string(mod->getModuleType()->getFullName()), std::string(mod->getName()))];
+    if (!pool.checked) {
+        pool.checked = true;
+        pool.recyclable = true;
+        std::vector<cModule*> modules = getSubmodulesOfType<cModule>(mod, true);
+        modules.insert(modules.begin(), mod);
+        for (auto m : modules) {
+            // compound modules without a C++ class of their own have no state to reset
+            if (typeid(*m) == typeid(cModule)) continue;
+            if (dynamic_cast<RecyclableModule*>(m)) continue;
+            EV_WARN << "Not recycling modules of type " << mod->getModuleType()->getFullName() << ": " << m->getFullPath() << " does not implement RecyclableModule" << endl;
+            pool.recyclable = false;
+            break;
+        }
+    }
+    return pool.recyclable;
+}
+
+std::vector<RecyclableModule*> TraCIScenarioManager::getRecyclableModules(cModule* mod)
+{
+    std::vector<RecyclableModule*> modules = getSubmodulesOfType<RecyclableModule>(mod, true);
+    if (auto rm = dynamic_cast<RecyclableModule*>(mod)) modules.insert(modules.begin(), rm);
+    return modules;
+}
+
+void TraCIScenarioManager::parkModule(cModule* mod)
+{
+    RecyclableModule::prepareAll(getRecyclableModules(mod));
+    parkingModules.push_back(mod);
+}
+
+void TraCIScenarioManager::reinitializeModule(cModule* mod)
+{
+    RecyclableModule::reinitializeAll(getRecyclableModules(mod));
+}
+
+void TraCIScenarioManager::finishParking()
+{
+    std::unordered_set<int> moduleIds;
+    for (auto mod : parkingModules) {
+        moduleIds.insert(mod->getId());
+        for (auto m : getSubmodulesOfType<cModule>(mod, true)) {
+            moduleIds.insert(m->getId());
+        }
+    }
+
+    // a single pass over the future event set for all modules parked since the last call
+    cFutureEventSet* fes = getSimulation()->getFES();
+    std::vector<cEvent*> events;
+    for (int i = 0; i < fes->getLength(); i++) {
+        cMessage* msg = dynamic_cast<cMessage*>(fes->get(i));
+        if (!msg) continue;
+        if (moduleIds.find(msg->getArrivalModuleId()) == moduleIds.end()) continue;
+        if (msg->isSelfMessage()) throw cRuntimeError("Cannot recycle module %s: self message \"%s\" is still scheduled after prepareForRecycling", msg->getArrivalModule()->getFullPath().c_str(), msg->getName());
+        events.push_back(msg);
+    }
+    for (auto event : events) {
+        delete fes->remove(event);
+    }
+
+    for (auto mod : parkingModules) {
+        modulePools[std::make_pair(std::string(mod->getModuleType()->getFullName()), std::string(mod->getName()))].parked.push_back(mod);
+    }
+    parkingModules.clear();
 }
 
 void TraCIScenarioManager::executeOneTimestep()
@@ -611,7 +877,19 @@ void TraCIScenarioManager::executeOneTimestep()
     emit(traciTimestepBeginSignal, targetTime);
 
     if (isConnected()) {
-        TraCIBuffer buf = connection->query(CMD_SIMSTEP2, TraCIBuffer() << targetTime);
+        TraCIBuffer buf;
+        if (connection->hasPendingQuery()) {
+            // the step was requested in the background at the end of the last time step
+            buf = connection->finishQuery();
+            pipelinedSteps++;
+        }
+        else {
+            buf = connection->query(CMD_SIMSTEP2, TraCIBuffer() << targetTime);
+        }
+
+        std::vector<uint32_t> previousContextVehicles;
+        previousContextVehicles.swap(contextVehicles);
+        vehicleReportGeneration++;
 
         uint32_t count;
         buf >> count;
@@ -619,19 +897,26 @@ void TraCIScenarioManager::executeOneTimestep()
         for (uint32_t i = 0; i < count; ++i) {
             processSubcriptionResult(buf);
         }
+
+        if (useContextSubscriptions) removeVehiclesOutsideContext(previousContextVehicles);
     }
 
     emit(traciTimestepEndSignal, targetTime);
 
-    if (!autoShutdownTriggered) scheduleAt(simTime() + updateInterval, executeOneTimestepTrigger);
+    if (!parkingModules.empty()) finishParking();
+
+    if (!autoShutdownTriggered) {
+        if (pipelineSimulationSteps && isConnected()) {
+            // listeners would send their commands after the next step has already been requested
+            if (hasListeners(traciTimestepBeginSignal)) throw cRuntimeError("pipelineSimulationSteps cannot be used with modules that send TraCI commands at the beginning of a time step (e.g., TraCIVehicleInserter)");
+            connection->startQuery(CMD_SIMSTEP2, TraCIBuffer() << (targetTime + updateInterval));
+        }
+        scheduleAt(simTime() + updateInterval, executeOneTimestepTrigger);
+    }
 }
 
-void TraCIScenarioManager::subscribeToVehicleVariables(std::string vehicleId)
+std::list<uint8_t> TraCIScenarioManager::getVehicleVariables() const
 {
-    // subscribe to some attributes of the vehicle
-    simtime_t beginTime = 0;
-    simtime_t endTime = SimTime::getMaxTime();
-    std::string objectId = vehicleId;
     std::list<uint8_t> variables;
     variables.push_back(VAR_POSITION);
     variables.push_back(VAR_ROAD_ID);
@@ -641,6 +926,17 @@ void TraCIScenarioManager::subscribeToVehicleVariables(std::string vehicleId)
     variables.push_back(VAR_LENGTH);
     variables.push_back(VAR_HEIGHT);
     variables.push_back(VAR_WIDTH);
+    variables.push_back(VAR_TYPE);
+    return variables;
+}
+
+void TraCIScenarioManager::subscribeToVehicleVariables(const std::string& vehicleId)
+{
+    // subscribe to some attributes of the vehicle
+    simtime_t beginTime = 0;
+    simtime_t endTime = SimTime::getMaxTime();
+    const std::string& objectId = vehicleId;
+    std::list<uint8_t> variables = getVehicleVariables();
     uint8_t variableNumber = variables.size();
 
     TraCIBuffer buf1;
@@ -648,54 +944,82 @@ void TraCIScenarioManager::subscribeToVehicleVariables(std::string vehicleId)
     for (auto variable : variables) {
         buf1 << variable;
     }
-    TraCIBuffer buf = connection->query(CMD_SUBSCRIBE_VEHICLE_VARIABLE, buf1);
-    processSubcriptionResult(buf);
-    ASSERT(buf.eof());
+    connection->enqueue(CMD_SUBSCRIBE_VEHICLE_VARIABLE, buf1, true, [this](TraCIBuffer& buf) {
+        processSubcriptionResult(buf);
+        ASSERT(buf.eof());
+    });
 }
 
-void TraCIScenarioManager::unsubscribeFromVehicleVariables(std::string vehicleId)
+void TraCIScenarioManager::unsubscribeFromVehicleVariables(const std::string& vehicleId)
 {
     // subscribe to some attributes of the vehicle
     simtime_t beginTime = 0;
     simtime_t endTime = SimTime::getMaxTime();
-    std::string objectId = vehicleId;
+    const std::string& objectId = vehicleId;
     uint8_t variableNumber = 0;
 
-    TraCIBuffer buf = connection->query(CMD_SUBSCRIBE_VEHICLE_VARIABLE, TraCIBuffer() << beginTime << endTime << objectId << variableNumber);
-    ASSERT(buf.eof());
+    // unsubscribing is answered by a status only
+    connection->enqueue(CMD_SUBSCRIBE_VEHICLE_VARIABLE, TraCIBuffer() << beginTime << endTime << objectId << variableNumber, false);
 }
-void TraCIScenarioManager::subscribeToTrafficLightVariables(std::string tlId)
+void TraCIScenarioManager::subscribeToVehicleContext(const std::string& poiId, double range)
+{
+    // subscribe to some attributes of all vehicles within range of the point of interest
+    simtime_t beginTime = 0;
+    simtime_t endTime = SimTime::getMaxTime();
+    const std::string& objectId = poiId;
+    uint8_t contextDomain = CMD_GET_VEHICLE_VARIABLE;
+    std::list<uint8_t> variables = getVehicleVariables();
+    uint8_t variableNumber = variables.size();
+
+    TraCIBuffer buf1;
+    buf1 << beginTime << endTime << objectId << contextDomain << range << variableNumber;
+    for (auto variable : variables) {
+        buf1 << variable;
+    }
+    connection->enqueue(CMD_SUBSCRIBE_POI_CONTEXT, buf1, true, [this](TraCIBuffer& buf) {
+        processSubcriptionResult(buf);
+        ASSERT(buf.eof());
+    });
+
+    // filters apply to the preceding context subscription
+    if (!contextSubscriptionVehicleTypes.empty()) {
+        connection->enqueue(CMD_ADD_SUBSCRIPTION_FILTER, TraCIBuffer() << FILTER_TYPE_VTYPE << static_cast<uint8_t>(TYPE_STRINGLIST) << contextSubscriptionVehicleTypes, false);
+    }
+}
+
+void TraCIScenarioManager::subscribeToTrafficLightVariables(const std::string& tlId)
 {
     // subscribe to some attributes of the traffic light system
     simtime_t beginTime = 0;
     simtime_t endTime = SimTime::getMaxTime();
-    std::string objectId = tlId;
+    const std::string& objectId = tlId;
     uint8_t variableNumber = 4;
     uint8_t variable1 = TL_CURRENT_PHASE;
     uint8_t variable2 = TL_CURRENT_PROGRAM;
     uint8_t variable3 = TL_NEXT_SWITCH;
     uint8_t variable4 = TL_RED_YELLOW_GREEN_STATE;
 
-    TraCIBuffer buf = connection->query(CMD_SUBSCRIBE_TL_VARIABLE, TraCIBuffer() << beginTime << endTime << objectId << variableNumber << variable1 << variable2 << variable3 << variable4);
-    processSubcriptionResult(buf);
-    ASSERT(buf.eof());
+    connection->enqueue(CMD_SUBSCRIBE_TL_VARIABLE, TraCIBuffer() << beginTime << endTime << objectId << variableNumber << variable1 << variable2 << variable3 << variable4, true, [this](TraCIBuffer& buf) {
+        processSubcriptionResult(buf);
+        ASSERT(buf.eof());
+    });
 }
 
-void TraCIScenarioManager::unsubscribeFromTrafficLightVariables(std::string tlId)
+void TraCIScenarioManager::unsubscribeFromTrafficLightVariables(const std::string& tlId)
 {
     // unsubscribe from some attributes of the traffic light system
     // this method is mainly for completeness as traffic lights are not supposed to be removed at runtime
 
     simtime_t beginTime = 0;
     simtime_t endTime = SimTime::getMaxTime();
-    std::string objectId = tlId;
+    const std::string& objectId = tlId;
     uint8_t variableNumber = 0;
 
     TraCIBuffer buf = connection->query(CMD_SUBSCRIBE_TL_VARIABLE, TraCIBuffer() << beginTime << endTime << objectId << variableNumber);
     ASSERT(buf.eof());
 }
 
-void TraCIScenarioManager::processTrafficLightSubscription(std::string objectId, TraCIBuffer& buf)
+void TraCIScenarioManager::processTrafficLightSubscription(const std::string& objectId, TraCIBuffer& buf)
 {
     cModule* tlIfSubmodule = trafficLights[objectId]->getSubmodule("tlInterface");
     TraCITrafficLightInterface* tlIfModule = dynamic_cast<TraCITrafficLightInterface*>(tlIfSubmodule);
@@ -743,7 +1067,7 @@ void TraCIScenarioManager::processTrafficLightSubscription(std::string objectId,
     }
 }
 
-void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuffer& buf)
+void TraCIScenarioManager::processSimSubscription(const std::string& objectId, TraCIBuffer& buf)
 {
     uint8_t variableNumber_resp;
     buf >> variableNumber_resp;
@@ -770,9 +1094,8 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
             buf >> count;
             EV_DEBUG << "TraCI reports " << count << " departed vehicles." << endl;
             for (uint32_t i = 0; i < count; ++i) {
-                std::string idstring;
-                buf >> idstring;
                 // adding modules is handled on the fly when entering/leaving the ROI
+                buf.readStringView();
             }
 
             activeVehicleCount += count;
@@ -789,18 +1112,22 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
                 std::string idstring;
                 buf >> idstring;
 
-                if (subscribedVehicles.find(idstring) != subscribedVehicles.end()) {
-                    subscribedVehicles.erase(idstring);
-                    // no unsubscription via TraCI possible/necessary as of SUMO 1.0.0 (the vehicle has arrived)
-                }
+                uint32_t index = findVehicleIndex(idstring);
+                if (index == noVehicleIndex) continue;
+
+                // no unsubscription via TraCI possible/necessary as of SUMO 1.0.0 (the vehicle has arrived)
+                vehicles[index].subscribed = false;
+                vehicles[index].variablesUnsubscribed = false;
 
                 // check if this object has been deleted already (e.g. because it was outside the ROI)
-                cModule* mod = getManagedModule(idstring);
-                if (mod) deleteManagedModule(idstring);
+                if (vehicles[index].module) deleteManagedModule(idstring);
 
-                if (unEquippedHosts.find(idstring) != unEquippedHosts.end()) {
-                    unEquippedHosts.erase(idstring);
+                if (vehicles[index].unequipped) {
+                    vehicles[index].unequipped = false;
+                    unequippedVehicleCount--;
                 }
+
+                releaseVehicle(index);
             }
 
             if ((count > 0) && (count >= activeVehicleCount) && autoShutdown) autoShutdownTriggered = true;
@@ -818,13 +1145,18 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
                 std::string idstring;
                 buf >> idstring;
 
+                uint32_t index = findVehicleIndex(idstring);
+                if (index == noVehicleIndex) continue;
+
                 // check if this object has been deleted already (e.g. because it was outside the ROI)
-                cModule* mod = getManagedModule(idstring);
-                if (mod) deleteManagedModule(idstring);
+                if (vehicles[index].module) deleteManagedModule(idstring);
 
-                if (unEquippedHosts.find(idstring) != unEquippedHosts.end()) {
-                    unEquippedHosts.erase(idstring);
+                if (vehicles[index].unequipped) {
+                    vehicles[index].unequipped = false;
+                    unequippedVehicleCount--;
                 }
+
+                releaseVehicle(index);
             }
 
             activeVehicleCount -= count;
@@ -838,9 +1170,8 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
             buf >> count;
             EV_DEBUG << "TraCI reports " << count << " vehicles ending teleport." << endl;
             for (uint32_t i = 0; i < count; ++i) {
-                std::string idstring;
-                buf >> idstring;
                 // adding modules is handled on the fly when entering/leaving the ROI
+                buf.readStringView();
             }
 
             activeVehicleCount += count;
@@ -922,9 +1253,63 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
     }
 }
 
-void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraCIBuffer& buf)
+void TraCIScenarioManager::processVehicleSubscription(const std::string& objectId, TraCIBuffer& buf)
+{
+    uint32_t index = findVehicleIndex(objectId);
+    bool isSubscribed = (index != noVehicleIndex) && vehicles[index].subscribed;
+    uint8_t variableNumber_resp;
+    buf >> variableNumber_resp;
+    processVehicleVariables(index, variableNumber_resp, buf, isSubscribed);
+}
+
+void TraCIScenarioManager::processVehicleContextSubscription(const std::string& objectId, TraCIBuffer& buf)
+{
+    uint8_t contextDomain;
+    buf >> contextDomain;
+    ASSERT(contextDomain == CMD_GET_VEHICLE_VARIABLE);
+    uint8_t variableNumber_resp;
+    buf >> variableNumber_resp;
+    uint32_t count;
+    buf >> count;
+    EV_DEBUG << "TraCI reports " << count << " vehicles around " << objectId << endl;
+    std::string vehicleId; // re-used for all vehicles, so it is only allocated once
+    for (uint32_t i = 0; i < count; ++i) {
+        TraCIBuffer::StringView vehicleIdView = buf.readStringView();
+        vehicleId.assign(vehicleIdView.data, vehicleIdView.size);
+        // vehicles near more than one ROI rectangle are reported once per rectangle, only use the first report
+        uint32_t index = internVehicleId(vehicleId);
+        bool isFirstReport = (vehicles[index].lastReported != vehicleReportGeneration);
+        if (isFirstReport) {
+            vehicles[index].lastReported = vehicleReportGeneration;
+            contextVehicles.push_back(index);
+        }
+        processVehicleVariables(index, variableNumber_resp, buf, isFirstReport);
+    }
+}
+
+void TraCIScenarioManager::removeVehiclesOutsideContext(const std::vector<uint32_t>& previousContextVehicles)
+{
+    for (uint32_t index : previousContextVehicles) {
+        // skip vehicles reported again in this time step (and vehicles forgotten in the meantime)
+        if (vehicles[index].id.empty() || (vehicles[index].lastReported == vehicleReportGeneration)) continue;
+
+        std::string objectId = vehicles[index].id;
+        if (vehicles[index].module) {
+            deleteManagedModule(objectId);
+            EV_DEBUG << "Vehicle #" << objectId << " left region of interest" << endl;
+        }
+        else if (vehicles[index].unequipped) {
+            vehicles[index].unequipped = false;
+            unequippedVehicleCount--;
+            EV_DEBUG << "Vehicle (unequipped) # " << objectId << " left region of interest" << endl;
+        }
+
+        releaseVehicle(index);
+    }
+}
+
+void TraCIScenarioManager::processVehicleVariables(uint32_t index, uint8_t variableNumber_resp, TraCIBuffer& buf, bool isSubscribed)
 {
-    bool isSubscribed = (subscribedVehicles.find(objectId) != subscribedVehicles.end());
     double px;
     double py;
     std::string edge;
@@ -934,10 +1319,9 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
     double length;
     double height;
     double width;
+    std::string vType;
     int numRead = 0;
 
-    uint8_t variableNumber_resp;
-    buf >> variableNumber_resp;
     for (uint8_t j = 0; j < variableNumber_resp; ++j) {
         uint8_t variable1_resp;
         buf >> variable1_resp;
@@ -962,28 +1346,37 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
             buf >> count;
             EV_DEBUG << "TraCI reports " << count << " active vehicles." << endl;
             ASSERT(count == activeVehicleCount);
-            std::set<std::string> drivingVehicles;
+            vehicleReportGeneration++;
+            std::string idstring; // re-used for all vehicles, so it is only allocated once
             for (uint32_t i = 0; i < count; ++i) {
-                std::string idstring;
-                buf >> idstring;
-                drivingVehicles.insert(idstring);
-            }
-
-            // check for vehicles that need subscribing to
-            std::set<std::string> needSubscribe;
-            std::set_difference(drivingVehicles.begin(), drivingVehicles.end(), subscribedVehicles.begin(), subscribedVehicles.end(), std::inserter(needSubscribe, needSubscribe.begin()));
-            for (std::set<std::string>::const_iterator i = needSubscribe.begin(); i != needSubscribe.end(); ++i) {
-                subscribedVehicles.insert(*i);
-                subscribeToVehicleVariables(*i);
+                TraCIBuffer::StringView idView = buf.readStringView();
+                idstring.assign(idView.data, idView.size);
+                uint32_t index = internVehicleId(idstring);
+                vehicles[index].lastReported = vehicleReportGeneration;
+
+                // check for vehicles that need subscribing to
+                if (!vehicles[index].subscribed) {
+                    vehicles[index].subscribed = true;
+                    subscribeToVehicleVariables(idstring);
+                }
             }
 
             // check for vehicles that need unsubscribing from
-            std::set<std::string> needUnsubscribe;
-            std::set_difference(subscribedVehicles.begin(), subscribedVehicles.end(), drivingVehicles.begin(), drivingVehicles.end(), std::inserter(needUnsubscribe, needUnsubscribe.begin()));
-            for (std::set<std::string>::const_iterator i = needUnsubscribe.begin(); i != needUnsubscribe.end(); ++i) {
-                subscribedVehicles.erase(*i);
-                unsubscribeFromVehicleVariables(*i);
+            for (uint32_t index = 0; index < vehicles.size(); ++index) {
+                if (!vehicles[index].subscribed || (vehicles[index].lastReported == vehicleReportGeneration)) continue;
+                vehicles[index].subscribed = false;
+                // SUMO answers a second unsubscribe with an error
+                if (vehicles[index].variablesUnsubscribed) {
+                    vehicles[index].variablesUnsubscribed = false;
+                }
+                else {
+                    unsubscribeFromVehicleVariables(vehicles[index].id);
+                }
+                releaseVehicle(index);
             }
+
+            // send all (un)subscriptions at once
+            connection->flush();
         }
         else if (variable1_resp == VAR_POSITION) {
             uint8_t varType;
@@ -1042,6 +1435,13 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
             buf >> width;
             numRead++;
         }
+        else if (variable1_resp == VAR_TYPE) {
+            uint8_t varType;
+            buf >> varType;
+            ASSERT(varType == TYPE_STRING);
+            buf >> vType;
+            numRead++;
+        }
         else {
             throw cRuntimeError("Received unhandled vehicle subscription result");
         }
@@ -1051,14 +1451,17 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
     if (!isSubscribed) return;
 
     // make sure we got updates for all attributes
-    if (numRead != 8) return;
+    if (numRead != 9) return;
 
     Coord p = connection->traci2omnet(TraCICoord(px, py));
     if ((p.x < 0) || (p.y < 0)) throw cRuntimeError("received bad node position (%.2f, %.2f), translated to (%.2f, %.2f)", px, py, p.x, p.y);
 
     Heading heading = connection->traci2omnetHeading(angle_traci);
 
-    cModule* mod = getManagedModule(objectId);
+    // subscription results are only processed for vehicles that have been interned already
+    ASSERT(index != noVehicleIndex);
+    const std::string& objectId = vehicles[index].id;
+    cModule* mod = vehicles[index].module;
 
     // is it in the ROI?
     bool inRoi = !roi.hasConstraints() ? true : (roi.onAnyRectangle(TraCICoord(px, py)) || roi.partOfRoads(edge));
@@ -1067,20 +1470,20 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
             deleteManagedModule(objectId);
             EV_DEBUG << "Vehicle #" << objectId << " left region of interest" << endl;
         }
-        else if (unEquippedHosts.find(objectId) != unEquippedHosts.end()) {
-            unEquippedHosts.erase(objectId);
+        else if (vehicles[index].unequipped) {
+            vehicles[index].unequipped = false;
+            unequippedVehicleCount--;
             EV_DEBUG << "Vehicle (unequipped) # " << objectId << " left region of interest" << endl;
         }
         return;
     }
 
-    if (isModuleUnequipped(objectId)) {
+    if (vehicles[index].unequipped) {
         return;
     }
 
     if (!mod) {
         // no such module - need to create
-        std::string vType = commandIfc->vehicle(objectId).getTypeId();
         std::string mType, mName, mDisplayString;
         TypeMapping::iterator iType, iName, iDisplayString;
 
@@ -1139,6 +1542,8 @@ void TraCIScenarioManager::processSubcriptionResult(TraCIBuffer& buf)
         processSimSubscription(objectId_resp, buf);
     else if (commandId_resp == RESPONSE_SUBSCRIBE_TL_VARIABLE)
         processTrafficLightSubscription(objectId_resp, buf);
+    else if (commandId_resp == RESPONSE_SUBSCRIBE_POI_CONTEXT)
+        processVehicleContextSubscription(objectId_resp, buf);
     else {
         throw cRuntimeError("Received unhandled subscription result");
     }
@@ -22,10 +22,13 @@
 
 #pragma once
 
+#include <limits>
 #include <map>
 #include <memory>
 #include <list>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -46,6 +49,7 @@ namespace veins {
 
 class TraCICommandInterface;
 class MobileHostObstacle;
+class RecyclableModule;
 
 /**
  * @brief
@@ -131,6 +135,8 @@ protected:
     TypeMapping moduleDisplayString; /**< module displayString to be used in the simulation for each managed vehicle */
     std::string host;
     int port;
+    std::string polygonFile; /**< SUMO polygon file to read radio obstacles from (empty to query polygons via TraCI) */
+    std::string recordTraceFile; /**< file to record all messages exchanged with the TraCI server to (see TraCITrace), if not empty */
 
     std::string trafficLightModuleType; /**< module type to be used in the simulation for each managed traffic light */
     std::string trafficLightModuleName; /**< module name to be used in the simulation for each managed traffic light */
@@ -139,6 +145,13 @@ protected:
 
     bool autoShutdown; /**< Shutdown module as soon as no more vehicles are in the simulation */
     double penetrationRate;
+    bool unsubscribeUnequippedVehicles; /**< whether to stop receiving updates for unequipped vehicles */
+    bool useContextSubscriptions; /**< whether to receive vehicles via context subscriptions around the ROI rectangles (instead of subscribing to each vehicle) */
+    std::list<std::string> contextSubscriptionVehicleTypes; /**< vehicle types to receive via context subscriptions (empty for all) */
+    bool pipelineSimulationSteps; /**< whether to request the next simulation step while OMNeT++ is still processing the current one */
+    long pipelinedSteps; /**< number of simulation steps whose results were received in the background */
+    bool cacheStaticData; /**< whether to enable the static data cache of the command interface */
+    bool recycleVehicleModules; /**< whether to re-use modules of vehicles that left the simulation for new vehicles (see RecyclableModule) */
     bool ignoreGuiCommands; /**< whether to ignore all TraCI commands that only make sense when the server has a graphical user interface */
     TraCIRegionOfInterest roi; /**< Can return whether a given position lies within the simulation's region of interest. Modules are destroyed and re-created as managed vehicles leave and re-enter the ROI */
     double areaSum;
@@ -149,8 +162,26 @@ protected:
 
     size_t nextNodeVectorIndex; /**< next OMNeT++ module vector index to use */
     std::map<std::string, cModule*> hosts; /**< vector of all hosts managed by us */
-    std::set<std::string> unEquippedHosts;
-    std::set<std::string> subscribedVehicles; /**< all vehicles we have already subscribed to */
+
+    /**
+     * state of a vehicle, indexed by its interned id (see internVehicleId)
+     */
+    struct VehicleState {
+        std::string id; /**< SUMO vehicle id (empty if this entry is unused) */
+        cModule* module = nullptr; /**< managed module of the vehicle, if any */
+        bool subscribed = false; /**< whether we have already subscribed to the vehicle */
+        bool variablesUnsubscribed = false; /**< whether we already unsubscribed from the variables of a subscribed vehicle (see unsubscribeUnequippedVehicles) */
+        bool unequipped = false; /**< whether the vehicle was chosen to be unequipped */
+        uint64_t lastReported = 0; /**< value of vehicleReportGeneration when the vehicle was last reported by the ID_LIST or a context subscription */
+        const MobileHostObstacle* obstacle = nullptr; /**< obstacle of the vehicle, if vehicleObstacleControl is used */
+    };
+    static const uint32_t noVehicleIndex = std::numeric_limits<uint32_t>::max();
+    std::unordered_map<std::string, uint32_t> vehicleIndices; /**< interned vehicle ids */
+    std::vector<VehicleState> vehicles; /**< by interned vehicle id */
+    std::vector<uint32_t> freeVehicleIndices; /**< interned vehicle ids no longer in use, to be re-used */
+    size_t unequippedVehicleCount; /**< number of vehicles chosen to be unequipped */
+    uint64_t vehicleReportGeneration; /**< incremented for each ID_LIST and each time step, see VehicleState::lastReported */
+    std::vector<uint32_t> contextVehicles; /**< all vehicles reported by context subscriptions in the current time step */
     std::map<std::string, cModule*> trafficLights; /**< vector of all traffic lights managed by us */
     uint32_t activeVehicleCount; /**< number of vehicles, be it parking or driving **/
     uint32_t parkingVehicleCount; /**< number of parking vehicles, derived from parking start/end events */
@@ -159,31 +190,60 @@ protected:
     cMessage* connectAndStartTrigger; /**< self-message scheduled for when to connect to TraCI server and start running */
     cMessage* executeOneTimestepTrigger; /**< self-message scheduled for when to next call executeOneTimestep */
 
+    /**
+     * modules of one module type (and name) that can be re-used for new vehicles
+     */
+    struct ModulePool {
+        bool checked = false; /**< whether recyclable has been determined yet */
+        bool recyclable = false; /**< whether all simple modules of this type implement RecyclableModule */
+        std::vector<cModule*> parked; /**< modules ready to be re-used (see finishParking) */
+        long created = 0; /**< number of modules created */
+        long recycled = 0; /**< number of times a module was re-used */
+        double constructionTime = 0; /**< total wall clock time spent creating and building modules (in s) */
+    };
+    std::map<std::pair<std::string, std::string>, ModulePool> modulePools; /**< by module type and name */
+    std::vector<cModule*> parkingModules; /**< modules prepared for re-use that may still have messages on their way to them */
+
     BaseWorldUtility* world;
-    std::map<const BaseMobility*, const MobileHostObstacle*> vehicleObstacles;
     VehicleObstacleControl* vehicleObstacleControl;
 
     void executeOneTimestep(); /**< read and execute all commands for the next timestep */
 
+    virtual TraCIConnection* createConnection(); /**< returns a new connection to the TraCI server */
     virtual void init_traci();
 
     virtual void preInitializeModule(cModule* mod, const std::string& nodeId, const Coord& position, const std::string& road_id, double speed, Heading heading, VehicleSignalSet signals);
     virtual void updateModulePosition(cModule* mod, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals);
     void addModule(std::string nodeId, std::string type, std::string name, std::string displayString, const Coord& position, std::string road_id = "", double speed = -1, Heading heading = Heading::nan, VehicleSignalSet signals = {VehicleSignal::undefined}, double length = 0, double height = 0, double width = 0);
-    cModule* getManagedModule(std::string nodeId); /**< returns a pointer to the managed module named moduleName, or 0 if no module can be found */
-    void deleteManagedModule(std::string nodeId);
+    cModule* getManagedModule(const std::string& nodeId); /**< returns a pointer to the managed module named moduleName, or 0 if no module can be found */
+    void deleteManagedModule(const std::string& nodeId);
+
+    bool isRecyclable(cModule* mod); /**< returns whether all simple modules of mod implement RecyclableModule */
+    std::vector<RecyclableModule*> getRecyclableModules(cModule* mod); /**< returns mod and all its submodules implementing RecyclableModule, parents first */
+    void parkModule(cModule* mod); /**< prepares the module for re-use and adds it to parkingModules */
+    void reinitializeModule(cModule* mod); /**< re-initializes a parked module (see RecyclableModule) */
+    void finishParking(); /**< deletes all messages on their way to parkingModules and adds them to their pools */
+
+    bool isModuleUnequipped(const std::string& nodeId); /**< returns true if this vehicle is Unequipped */
 
-    bool isModuleUnequipped(std::string nodeId); /**< returns true if this vehicle is Unequipped */
+    uint32_t internVehicleId(const std::string& vehicleId); /**< returns the index of a vehicle in vehicles, adding it if needed */
+    uint32_t findVehicleIndex(const std::string& vehicleId) const; /**< returns the index of a vehicle in vehicles, or noVehicleIndex */
+    void releaseVehicle(uint32_t index); /**< forgets a vehicle if no state is left that needs to be kept */
 
-    void subscribeToVehicleVariables(std::string vehicleId);
-    void unsubscribeFromVehicleVariables(std::string vehicleId);
-    void processSimSubscription(std::string objectId, TraCIBuffer& buf);
-    void processVehicleSubscription(std::string objectId, TraCIBuffer& buf);
+    std::list<uint8_t> getVehicleVariables() const; /**< returns the vehicle variables to subscribe to */
+    void subscribeToVehicleVariables(const std::string& vehicleId);
+    void unsubscribeFromVehicleVariables(const std::string& vehicleId);
+    void subscribeToVehicleContext(const std::string& poiId, double range); /**< subscribes to vehicles within range of a point of interest */
+    void processSimSubscription(const std::string& objectId, TraCIBuffer& buf);
+    void processVehicleSubscription(const std::string& objectId, TraCIBuffer& buf);
+    void processVehicleContextSubscription(const std::string& objectId, TraCIBuffer& buf);
+    void processVehicleVariables(uint32_t index, uint8_t variableNumber_resp, TraCIBuffer& buf, bool isSubscribed); /**< index of the vehicle in vehicles (may be noVehicleIndex if isSubscribed is false) */
+    void removeVehiclesOutsideContext(const std::vector<uint32_t>& previousContextVehicles); /**< removes vehicles no longer reported by any context subscription */
     void processSubcriptionResult(TraCIBuffer& buf);
 
-    void subscribeToTrafficLightVariables(std::string tlId);
-    void unsubscribeFromTrafficLightVariables(std::string tlId);
-    void processTrafficLightSubscription(std::string objectId, TraCIBuffer& buf);
+    void subscribeToTrafficLightVariables(const std::string& tlId);
+    void unsubscribeFromTrafficLightVariables(const std::string& tlId);
+    void processTrafficLightSubscription(const std::string& objectId, TraCIBuffer& buf);
     /**
      * parses the vector of module types in ini file
      *
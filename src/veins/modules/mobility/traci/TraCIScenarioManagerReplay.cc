@@ -0,0 +1,64 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/modules/mobility/traci/TraCIScenarioManagerReplay.h"
+#include "veins/modules/mobility/traci/TraCIConnection.h"
+
+using veins::TraCIConnection;
+using veins::TraCIScenarioManagerReplay;
+
+Define_Module(veins::TraCIScenarioManagerReplay);
+
+void TraCIScenarioManagerReplay::initialize(int stage)
+{
+    if (stage == 1) {
+        traceFile = par("traceFile").stdstringValue();
+    }
+    TraCIScenarioManager::initialize(stage);
+    if (stage == 1) {
+        if (!recordTraceFile.empty()) throw cRuntimeError("Cannot record a TraCI trace while replaying one, set recordTraceFile to \"\"");
+    }
+}
+
+TraCIConnection* TraCIScenarioManagerReplay::createConnection()
+{
+    std::unique_ptr<TraCIConnection> connection(TraCIConnection::replay(this, traceFile));
+    checkTraceCoversSimTimeLimit(connection->getReplayedTrace());
+    return connection.release();
+}
+
+void TraCIScenarioManagerReplay::checkTraceCoversSimTimeLimit(const TraCITraceReader& trace) const
+{
+    // with autoShutdown, the recording may have ended before sim-time-limit (and so will the replay)
+    if (autoShutdown) return;
+
+    const char* simTimeLimitValue = cSimulation::getActiveSimulation()->getEnvir()->getConfig()->getConfigValue("sim-time-limit");
+    if (!simTimeLimitValue) throw cRuntimeError("Cannot replay TraCI trace file \"%s\" without a sim-time-limit, as it ends after %zu simulation steps", traceFile.c_str(), trace.getNumSteps());
+    const simtime_t simTimeLimit = SimTime::parse(simTimeLimitValue);
+
+    // a step is requested every updateInterval up to sim-time-limit, so the step after the last one recorded must lie beyond it
+    const simtime_t lastStepTime = (trace.getNumSteps() > 0) ? trace.getStepTime(trace.getNumSteps() - 1) : SIMTIME_ZERO;
+    if (lastStepTime + updateInterval < simTimeLimit) {
+        throw cRuntimeError("TraCI trace file \"%s\" ends with the simulation step to t=%s, so it cannot be replayed up to sim-time-limit=%s", traceFile.c_str(), lastStepTime.str().c_str(), simTimeLimit.str().c_str());
+    }
+}
@@ -0,0 +1,66 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include "veins/veins.h"
+
+#include "veins/modules/mobility/traci/TraCIScenarioManager.h"
+
+namespace veins {
+
+/**
+ * @brief
+ *
+ * Extends the TraCIScenarioManager to replay a trace recorded by a TraCIScenarioManager instead of connecting to a TraCI server.
+ *
+ * All other functionality is provided by the TraCIScenarioManager, which must be configured exactly as in the run that recorded the trace.
+ * Applications must send the same TraCI commands (including getters) as in that run, see TraCIScenarioManagerReplay.ned.
+ *
+ * @see TraCIConnection::replay
+ * @see TraCIScenarioManager
+ *
+ */
+class VEINS_API TraCIScenarioManagerReplay : virtual public TraCIScenarioManager {
+public:
+    void initialize(int stage) override;
+
+protected:
+    std::string traceFile; /**< trace to replay */
+
+    TraCIConnection* createConnection() override;
+
+    /**
+     * throws a cRuntimeError if the trace ends before sim-time-limit (so replaying it would fail when reaching its end)
+     */
+    void checkTraceCoversSimTimeLimit(const TraCITraceReader& trace) const;
+};
+
+class VEINS_API TraCIScenarioManagerReplayAccess {
+public:
+    TraCIScenarioManagerReplay* get()
+    {
+        return FindModule<TraCIScenarioManagerReplay*>::findGlobalModule();
+    };
+};
+} // namespace veins
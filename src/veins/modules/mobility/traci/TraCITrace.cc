@@ -0,0 +1,162 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <stdexcept>
+
+#include "veins/modules/mobility/traci/TraCITrace.h"
+#include "veins/modules/mobility/traci/TraCIBuffer.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+
+using namespace veins::TraCIConstants;
+
+namespace veins {
+
+namespace {
+
+const std::string headerMagic = "VEINSTRC";
+const std::string footerMagic = "VEINSIDX";
+const size_t headerLength = 8 + sizeof(uint32_t);
+const size_t recordHeaderLength = sizeof(uint8_t) + sizeof(uint32_t);
+const size_t footerLength = sizeof(uint64_t) + 8;
+
+} // namespace
+
+uint8_t TraCITrace::getFirstCommandId(const std::string& message)
+{
+    // commands start with a one byte length, or a zero byte followed by a four byte length
+    if (message.size() < 2) return 0;
+    if (message[0] != 0) return static_cast<uint8_t>(message[1]);
+    if (message.size() < 6) return 0;
+    return static_cast<uint8_t>(message[5]);
+}
+
+simtime_t TraCITrace::getStepTargetTime(const std::string& message)
+{
+    TraCIBuffer buf(message);
+    if (buf.read<uint8_t>() == 0) buf.read<uint32_t>();
+    buf.read<uint8_t>(); // command id
+    return buf.read<simtime_t>();
+}
+
+TraCITraceWriter::TraCITraceWriter(const std::string& fileName)
+    : file(fileName, std::ios::binary | std::ios::trunc)
+    , fileName(fileName)
+{
+    if (!file) throw cRuntimeError("Could not open TraCI trace file \"%s\" for writing", fileName.c_str());
+    file << headerMagic << (TraCIBuffer() << TraCITrace::version).str();
+    offset = headerLength;
+}
+
+TraCITraceWriter::~TraCITraceWriter()
+{
+    TraCIBuffer index;
+    index << static_cast<uint32_t>(stepOffsets.size());
+    for (size_t i = 0; i < stepOffsets.size(); ++i) index << stepOffsets[i] << stepTimes[i];
+    index << offset;
+    file << index.str() << footerMagic;
+    file.flush();
+}
+
+void TraCITraceWriter::write(TraCITrace::Direction direction, const std::string& message)
+{
+    if ((direction == TraCITrace::SENT) && (TraCITrace::getFirstCommandId(message) == CMD_SIMSTEP2)) {
+        stepOffsets.push_back(offset);
+        stepTimes.push_back(TraCITrace::getStepTargetTime(message).dbl());
+    }
+    file << (TraCIBuffer() << static_cast<uint8_t>(direction) << static_cast<uint32_t>(message.size())).str() << message;
+    if (!file) throw std::runtime_error("Could not write to TraCI trace file \"" + fileName + "\"");
+    offset += recordHeaderLength + message.size();
+}
+
+TraCITraceReader::TraCITraceReader(const std::string& fileName)
+    : file(fileName, std::ios::binary)
+    , fileName(fileName)
+{
+    if (!file) throw cRuntimeError("Could not open TraCI trace file \"%s\"", fileName.c_str());
+
+    std::string header(headerLength, '\0');
+    if (!file.read(&header[0], headerLength) || (header.compare(0, headerMagic.size(), headerMagic) != 0)) {
+        throw cRuntimeError("\"%s\" is not a TraCI trace file", fileName.c_str());
+    }
+    uint32_t fileVersion = TraCIBuffer(header.substr(headerMagic.size())).read<uint32_t>();
+    if (fileVersion != TraCITrace::version) throw cRuntimeError("TraCI trace file \"%s\" has unsupported version %u (expected %u)", fileName.c_str(), fileVersion, TraCITrace::version);
+
+    // the index is only written once recording has finished, so its absence means the trace is incomplete
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = file.tellg();
+    std::string footer(footerLength, '\0');
+    if ((fileSize < headerLength + sizeof(uint32_t) + footerLength) || !file.seekg(fileSize - footerLength) || !file.read(&footer[0], footerLength) || (footer.compare(sizeof(uint64_t), footerMagic.size(), footerMagic) != 0)) {
+        throw cRuntimeError("TraCI trace file \"%s\" is incomplete (the simulation that recorded it did not finish cleanly)", fileName.c_str());
+    }
+    indexOffset = TraCIBuffer(footer).read<uint64_t>();
+    if ((indexOffset < headerLength) || (indexOffset + sizeof(uint32_t) > fileSize - footerLength)) throw cRuntimeError("TraCI trace file \"%s\" has a corrupt index", fileName.c_str());
+
+    std::string index(fileSize - footerLength - indexOffset, '\0');
+    file.seekg(indexOffset);
+    file.read(&index[0], index.size());
+    TraCIBuffer buf(index);
+    uint32_t numSteps = buf.read<uint32_t>();
+    if (index.size() != sizeof(uint32_t) + numSteps * (sizeof(uint64_t) + sizeof(double))) throw cRuntimeError("TraCI trace file \"%s\" has a corrupt index", fileName.c_str());
+    stepOffsets.reserve(numSteps);
+    stepTimes.reserve(numSteps);
+    for (uint32_t i = 0; i < numSteps; ++i) {
+        stepOffsets.push_back(buf.read<uint64_t>());
+        stepTimes.push_back(buf.read<double>());
+        if ((stepOffsets.back() < headerLength) || (stepOffsets.back() >= indexOffset)) throw cRuntimeError("TraCI trace file \"%s\" has a corrupt index", fileName.c_str());
+    }
+
+    file.seekg(headerLength);
+    offset = headerLength;
+}
+
+std::string TraCITraceReader::read(TraCITrace::Direction direction)
+{
+    if (offset >= indexOffset) throw std::runtime_error("Reached the end of TraCI trace file \"" + fileName + "\" after " + std::to_string(numStepsRead) + " simulation steps");
+
+    std::string recordHeader(recordHeaderLength, '\0');
+    if (!file.read(&recordHeader[0], recordHeaderLength)) throw std::runtime_error("Could not read from TraCI trace file \"" + fileName + "\"");
+    TraCIBuffer buf(recordHeader);
+    uint8_t recordDirection = buf.read<uint8_t>();
+    uint32_t length = buf.read<uint32_t>();
+    if (offset + recordHeaderLength + length > indexOffset) throw std::runtime_error("TraCI trace file \"" + fileName + "\" is corrupt");
+    if (recordDirection != direction) {
+        throw std::runtime_error(std::string("Expected to ") + (direction == TraCITrace::SENT ? "send" : "receive") + " a TraCI message after " + std::to_string(getNumStepsRead()) + " simulation steps, but the trace " + (direction == TraCITrace::SENT ? "received" : "sent") + " one");
+    }
+
+    std::string message(length, '\0');
+    if ((length > 0) && !file.read(&message[0], length)) throw std::runtime_error("Could not read from TraCI trace file \"" + fileName + "\"");
+    offset += recordHeaderLength + length;
+    if ((direction == TraCITrace::SENT) && (TraCITrace::getFirstCommandId(message) == CMD_SIMSTEP2)) numStepsRead++;
+    return message;
+}
+
+void TraCITraceReader::seekToStep(size_t step)
+{
+    if (step >= stepOffsets.size()) throw std::runtime_error("TraCI trace file \"" + fileName + "\" has only " + std::to_string(stepOffsets.size()) + " simulation steps");
+    file.clear();
+    file.seekg(stepOffsets[step]);
+    offset = stepOffsets[step];
+    numStepsRead = step;
+}
+
+} // namespace veins
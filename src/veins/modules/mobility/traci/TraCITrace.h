@@ -0,0 +1,142 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Binary trace of the messages exchanged with a TraCI server, written by TraCITraceWriter and read by TraCITraceReader.
+ *
+ * Layout (all integers big endian, like in TraCI itself):
+ *  - header: magic "VEINSTRC", uint32 version
+ *  - one record per message: uint8 direction (SENT or RECEIVED), uint32 length, message (without the TraCI length header)
+ *  - index: uint32 number of simulation steps, then per step the uint64 file offset of the record that requested it and its double target time
+ *  - footer: uint64 file offset of the index, magic "VEINSIDX"
+ *
+ * The index is only written once recording has finished, so traces of aborted runs are recognized as incomplete.
+ * It tells which simulation time a trace covers before replaying it, and allows seeking to a simulation step.
+ *
+ * Reading and writing messages throws std::runtime_error (not cRuntimeError), so both can be used from the background thread of TraCIConnection::startQuery.
+ */
+namespace TraCITrace {
+
+enum Direction : uint8_t {
+    SENT = 'S', /**< message sent to the TraCI server */
+    RECEIVED = 'R' /**< message received from the TraCI server */
+};
+
+const uint32_t version = 3;
+
+/**
+ * returns the id of the first command in a TraCI message (0 if the message is empty or malformed)
+ */
+uint8_t getFirstCommandId(const std::string& message);
+
+/**
+ * returns the target time of a TraCI message starting with a CMD_SIMSTEP2 command
+ */
+simtime_t getStepTargetTime(const std::string& message);
+
+} // namespace TraCITrace
+
+/**
+ * writes a TraCITrace, adding the index once it is destroyed
+ */
+class VEINS_API TraCITraceWriter {
+public:
+    explicit TraCITraceWriter(const std::string& fileName);
+    ~TraCITraceWriter();
+
+    /**
+     * appends a message to the trace
+     */
+    void write(TraCITrace::Direction direction, const std::string& message);
+
+protected:
+    std::ofstream file;
+    std::string fileName;
+    uint64_t offset; /**< file offset of the next record */
+    std::vector<uint64_t> stepOffsets; /**< file offsets of all records that requested a simulation step */
+    std::vector<double> stepTimes; /**< target times of all simulation steps */
+};
+
+/**
+ * reads a complete TraCITrace (i.e., one that has an index)
+ */
+class VEINS_API TraCITraceReader {
+public:
+    explicit TraCITraceReader(const std::string& fileName);
+
+    /**
+     * returns the next message of the trace, which must have been exchanged in the given direction
+     */
+    std::string read(TraCITrace::Direction direction);
+
+    /**
+     * continues reading at the message that requested the given simulation step (counting from 0)
+     */
+    void seekToStep(size_t step);
+
+    /**
+     * returns the number of simulation steps requested in the trace
+     */
+    size_t getNumSteps() const
+    {
+        return stepOffsets.size();
+    }
+
+    /**
+     * returns the target time of the given simulation step (counting from 0)
+     */
+    simtime_t getStepTime(size_t step) const
+    {
+        return stepTimes.at(step);
+    }
+
+    /**
+     * returns the number of simulation steps requested in the trace before the next message
+     */
+    size_t getNumStepsRead() const
+    {
+        return numStepsRead;
+    }
+
+protected:
+    std::ifstream file;
+    std::string fileName;
+    uint64_t offset; /**< file offset of the next record */
+    uint64_t indexOffset; /**< file offset of the index, i.e., end of the last record */
+    std::vector<uint64_t> stepOffsets; /**< file offsets of all records that requested a simulation step */
+    std::vector<double> stepTimes; /**< target times of all simulation steps */
+    size_t numStepsRead = 0; /**< number of records read so far that requested a simulation step */
+};
+
+} // namespace veins
@@ -0,0 +1,145 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/modules/obstacle/AttenuationCache.h"
+
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <tuple>
+
+namespace veins {
+
+AttenuationCache::AttenuationCache(size_t capacity, double quantization)
+    : capacity(capacity)
+    , quantization(quantization)
+{
+    ASSERT(quantization >= 0);
+    index.reserve(capacity);
+}
+
+bool AttenuationCache::find(const Coord& senderPos, const Coord& receiverPos, double& factor)
+{
+    if (capacity == 0) return false;
+
+    auto it = index.find(makeKey(senderPos, receiverPos));
+    if (it == index.end()) {
+        numMisses++;
+        return false;
+    }
+
+    numHits++;
+    // move entry to front of LRU list
+    entries.splice(entries.begin(), entries, it->second);
+    factor = it->second->second;
+    return true;
+}
+
+bool AttenuationCache::contains(const Coord& senderPos, const Coord& receiverPos) const
+{
+    if (capacity == 0) return false;
+    return index.find(makeKey(senderPos, receiverPos)) != index.end();
+}
+
+void AttenuationCache::insert(const Coord& senderPos, const Coord& receiverPos, double factor)
+{
+    if (capacity == 0) return;
+
+    Key key = makeKey(senderPos, receiverPos);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = factor;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    if (index.size() >= capacity) {
+        // evict least recently used entry, reusing its list node
+        index.erase(entries.back().first);
+        entries.splice(entries.begin(), entries, std::prev(entries.end()));
+        entries.front() = std::make_pair(key, factor);
+    }
+    else {
+        entries.emplace_front(key, factor);
+    }
+    index.emplace(key, entries.begin());
+}
+
+void AttenuationCache::clear()
+{
+    entries.clear();
+    index.clear();
+}
+
+size_t AttenuationCache::size() const
+{
+    return index.size();
+}
+
+size_t AttenuationCache::getCapacity() const
+{
+    return capacity;
+}
+
+double AttenuationCache::getQuantization() const
+{
+    return quantization;
+}
+
+uint64_t AttenuationCache::getNumHits() const
+{
+    return numHits;
+}
+
+uint64_t AttenuationCache::getNumMisses() const
+{
+    return numMisses;
+}
+
+AttenuationCache::Key AttenuationCache::makeKey(const Coord& senderPos, const Coord& receiverPos) const
+{
+    Coord a = snap(senderPos);
+    Coord b = snap(receiverPos);
+
+    // order positions so both directions of a link map to the same key
+    if (std::tie(b.x, b.y, b.z) < std::tie(a.x, a.y, a.z)) std::swap(a, b);
+    return {a, b};
+}
+
+Coord AttenuationCache::snap(const Coord& pos) const
+{
+    if (quantization <= 0) return pos;
+    return Coord(std::round(pos.x / quantization) * quantization, std::round(pos.y / quantization) * quantization, std::round(pos.z / quantization) * quantization);
+}
+
+size_t AttenuationCache::KeyHash::operator()(const Key& key) const
+{
+    std::hash<double> h;
+    size_t seed = 0;
+    for (double v : {key.a.x, key.a.y, key.a.z, key.b.x, key.b.y, key.b.z}) {
+        seed ^= h(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+} // namespace veins
@@ -0,0 +1,111 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+
+namespace veins {
+
+/**
+ * Bounded cache of obstacle attenuation factors between pairs of positions.
+ *
+ * Entries are evicted in least-recently-used order once the capacity is reached.
+ * Positions can optionally be snapped to a grid before lookup, so nodes that moved less than the grid size since the last query reuse the cached result.
+ * This trades a bounded error in the sender and receiver positions for fewer ray casts.
+ * Keys are symmetric: the link from A to B shares its entry with the link from B to A.
+ *
+ * @see ObstacleControl
+ */
+class VEINS_API AttenuationCache {
+public:
+    /**
+     * @param capacity maximum number of entries (0 disables the cache)
+     * @param quantization size of the grid positions are snapped to in m (0 uses exact positions)
+     */
+    AttenuationCache(size_t capacity = 1000, double quantization = 0);
+
+    /**
+     * Look up the attenuation factor between two positions.
+     *
+     * @return true and set factor if an entry was found, false otherwise
+     */
+    bool find(const Coord& senderPos, const Coord& receiverPos, double& factor);
+
+    /**
+     * Return whether there is an entry for the attenuation factor between two positions (without counting this as a hit or miss, or marking the entry as used).
+     */
+    bool contains(const Coord& senderPos, const Coord& receiverPos) const;
+
+    /**
+     * Store the attenuation factor between two positions, evicting the least recently used entry if necessary.
+     */
+    void insert(const Coord& senderPos, const Coord& receiverPos, double factor);
+
+    /**
+     * Remove all entries (but keep hit and miss counters).
+     */
+    void clear();
+
+    size_t size() const;
+    size_t getCapacity() const;
+    double getQuantization() const;
+
+    uint64_t getNumHits() const;
+    uint64_t getNumMisses() const;
+
+private:
+    struct Key {
+        Coord a;
+        Coord b;
+
+        // exact comparison (unlike Coord::operator==), as required for hashing
+        bool operator==(const Key& o) const
+        {
+            return a.x == o.a.x && a.y == o.a.y && a.z == o.a.z && b.x == o.b.x && b.y == o.b.y && b.z == o.b.z;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    typedef std::list<std::pair<Key, double>> Entries;
+
+    Key makeKey(const Coord& senderPos, const Coord& receiverPos) const;
+    Coord snap(const Coord& pos) const;
+
+    size_t capacity;
+    double quantization;
+    Entries entries; /**< most recently used entry first */
+    std::unordered_map<Key, Entries::iterator, KeyHash> index;
+    uint64_t numHits = 0;
+    uint64_t numMisses = 0;
+};
+
+} // namespace veins
@@ -20,7 +20,8 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
-#include <set>
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include "veins/modules/obstacle/MobileHostObstacle.h"
 #include "veins/base/modules/BaseMobility.h"
@@ -29,60 +30,89 @@
 using veins::Coord;
 using veins::MobileHostObstacle;
 
-namespace {
-
-bool isPointInObstacle(Coord point, const MobileHostObstacle::Coords& shape)
+MobileHostObstacle::Rectangle MobileHostObstacle::Rectangle::fromHost(const Coord& position, double heading, double length, double hostPositionOffset, double width)
 {
-    bool isInside = false;
-    auto i = shape.begin();
-    auto j = (shape.rbegin() + 1).base();
-    for (; i != shape.end(); j = i++) {
-        bool inYRangeUp = (point.y >= i->y) && (point.y < j->y);
-        bool inYRangeDown = (point.y >= j->y) && (point.y < i->y);
-        bool inYRange = inYRangeUp || inYRangeDown;
-        if (!inYRange) continue;
-        bool intersects = point.x < (i->x + ((point.y - i->y) * (j->x - i->x) / (j->y - i->y)));
-        if (!intersects) continue;
-        isInside = !isInside;
-    }
-    return isInside;
+    Rectangle r;
+    r.position = position;
+    r.lengthAxis = Coord(cos(heading), -sin(heading));
+    r.widthAxis = Coord(sin(heading), cos(heading));
+    r.minLength = -(length - hostPositionOffset); // this is the shift we have to undo in order to (given the OMNeT++ host position) get the car's front bumper position
+    r.maxLength = hostPositionOffset;
+    r.halfWidth = width / 2;
+    return r;
 }
 
-double segmentsIntersectAt(Coord p1From, Coord p1To, Coord p2From, Coord p2To)
+std::array<Coord, 4> MobileHostObstacle::Rectangle::getCorners() const
 {
-    Coord p1Vec = p1To - p1From;
-    Coord p2Vec = p2To - p2From;
-    Coord p1p2 = p1From - p2From;
+    return {{
+        position + lengthAxis * minLength - widthAxis * halfWidth,
+        position + lengthAxis * maxLength - widthAxis * halfWidth,
+        position + lengthAxis * maxLength + widthAxis * halfWidth,
+        position + lengthAxis * minLength + widthAxis * halfWidth,
+    }};
+}
 
-    double D = (p1Vec.x * p2Vec.y - p1Vec.y * p2Vec.x);
+bool MobileHostObstacle::Rectangle::containsPoint(const Coord& point) const
+{
+    const double dx = point.x - position.x;
+    const double dy = point.y - position.y;
+    const double l = dx * lengthAxis.x + dy * lengthAxis.y;
+    const double w = dx * widthAxis.x + dy * widthAxis.y;
+    return (l >= minLength) && (l <= maxLength) && (w >= -halfWidth) && (w <= halfWidth);
+}
 
-    double p1Frac = (p2Vec.x * p1p2.y - p2Vec.y * p1p2.x) / D;
-    if (p1Frac < 0 || p1Frac > 1) return -1;
+double MobileHostObstacle::Rectangle::getIntersectionPoint(const Coord& senderPos, const Coord& receiverPos) const
+{
+    const double not_a_number = std::numeric_limits<double>::quiet_NaN();
 
-    double p2Frac = (p1Vec.x * p1p2.y - p1Vec.y * p1p2.x) / D;
-    if (p2Frac < 0 || p2Frac > 1) return -1;
+    // shortcut if sender is inside
+    if (containsPoint(senderPos)) return 0;
+
+    // transform the beam into the rectangle's coordinate system, where the rectangle is axis-aligned
+    const double sx = senderPos.x - position.x;
+    const double sy = senderPos.y - position.y;
+    const double dx = receiverPos.x - senderPos.x;
+    const double dy = receiverPos.y - senderPos.y;
+    const double origin[2] = {sx * lengthAxis.x + sy * lengthAxis.y, sx * widthAxis.x + sy * widthAxis.y};
+    const double direction[2] = {dx * lengthAxis.x + dy * lengthAxis.y, dx * widthAxis.x + dy * widthAxis.y};
+    const double lower[2] = {minLength, -halfWidth};
+    const double upper[2] = {maxLength, halfWidth};
+
+    // intersect the beam (as fractions in [0, 1] along senderPos--receiverPos) with both slabs of the rectangle
+    double enter = 0;
+    double exit = 1;
+    for (size_t axis = 0; axis < 2; ++axis) {
+        if (direction[axis] == 0) {
+            // beam is parallel to this slab: either always or never inside
+            if ((origin[axis] < lower[axis]) || (origin[axis] > upper[axis])) return not_a_number;
+            continue;
+        }
+        double t1 = (lower[axis] - origin[axis]) / direction[axis];
+        double t2 = (upper[axis] - origin[axis]) / direction[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        enter = std::max(enter, t1);
+        exit = std::min(exit, t2);
+    }
+    if (enter > exit) return not_a_number;
 
-    return p1Frac;
+    return enter * senderPos.distance(receiverPos);
 }
 
-} // namespace
-
 MobileHostObstacle::Coords MobileHostObstacle::getShape(simtime_t t) const
 {
-    double l = getLength();
-    double o = getHostPositionOffset(); // this is the shift we have to undo in order to (given the OMNeT++ host position) get the car's front bumper position
-    double w = getWidth() / 2;
-    const BaseMobility* m = getMobility();
-    Coord p = m->getPositionAt(t);
-    double a = Heading::fromCoord(m->getCurrentOrientation()).getRad();
+    auto corners = getRectangle(t).getCorners();
+    return Coords(corners.begin(), corners.end());
+}
 
-    Coords shape;
-    shape.push_back(p + Coord(-(l - o), -w).rotatedYaw(-a));
-    shape.push_back(p + Coord(+o, -w).rotatedYaw(-a));
-    shape.push_back(p + Coord(+o, +w).rotatedYaw(-a));
-    shape.push_back(p + Coord(-(l - o), +w).rotatedYaw(-a));
+const MobileHostObstacle::Rectangle& MobileHostObstacle::getRectangle(simtime_t t) const
+{
+    if (isRectangleValid && (rectangleTime == t)) return rectangle;
 
-    return shape;
+    const BaseMobility* m = getMobility();
+    rectangle = Rectangle::fromHost(m->getPositionAt(t), Heading::fromCoord(m->getCurrentOrientation()).getRad(), getLength(), getHostPositionOffset(), getWidth());
+    rectangleTime = t;
+    isRectangleValid = true;
+    return rectangle;
 }
 
 bool MobileHostObstacle::maybeInBounds(double x1, double y1, double x2, double y2, simtime_t t) const
@@ -110,37 +140,5 @@ bool MobileHostObstacle::maybeInBounds(double x1, double y1, double x2, double y
 
 double MobileHostObstacle::getIntersectionPoint(const Coord& senderPos, const Coord& receiverPos, simtime_t t) const
 {
-    const double not_a_number = std::numeric_limits<double>::quiet_NaN();
-
-    MobileHostObstacle::Coords shape = getShape(t);
-
-    // shortcut if sender is inside
-    bool senderInside = isPointInObstacle(senderPos, shape);
-    if (senderInside) return 0;
-
-    // get a list of points (in [0, 1]) along the line between sender and receiver where the beam intersects with this obstacle
-    std::multiset<double> intersectAt;
-    bool doesIntersect = false;
-    MobileHostObstacle::Coords::const_iterator i = shape.begin();
-    MobileHostObstacle::Coords::const_iterator j = (shape.rbegin() + 1).base();
-    for (; i != shape.end(); j = i++) {
-        Coord c1 = *i;
-        Coord c2 = *j;
-
-        double inter = segmentsIntersectAt(senderPos, receiverPos, c1, c2);
-        if (inter != -1) {
-            doesIntersect = true;
-            EV << "intersect: " << inter << endl;
-            intersectAt.insert(inter);
-        }
-    }
-
-    // shortcut if no intersections
-    if (!doesIntersect) {
-        bool receiverInside = isPointInObstacle(receiverPos, shape);
-        if (receiverInside) return senderPos.distance(receiverPos);
-        return not_a_number;
-    }
-
-    return (*intersectAt.begin() * senderPos.distance(receiverPos));
+    return getRectangle(t).getIntersectionPoint(senderPos, receiverPos);
 }
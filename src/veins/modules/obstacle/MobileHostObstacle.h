@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "veins/base/utils/Coord.h"
@@ -40,6 +41,38 @@ class VEINS_API MobileHostObstacle {
 public:
     using Coords = std::vector<Coord>;
 
+    /**
+     * Footprint of a mobile host: a rectangle, rotated according to the host's heading.
+     *
+     * Stored as the host position, two orthonormal axes, and the extent of the rectangle along each axis.
+     * All operations are closed-form and need no heap allocation.
+     */
+    struct Rectangle {
+        Coord position; /**< host position (origin of the local coordinate system) */
+        Coord lengthAxis; /**< unit vector along the length of the host */
+        Coord widthAxis; /**< unit vector along the width of the host */
+        double minLength; /**< extent along lengthAxis: rear bumper */
+        double maxLength; /**< extent along lengthAxis: front bumper */
+        double halfWidth; /**< extent along widthAxis (in both directions) */
+
+        /**
+         * Build the footprint of a host at position, facing heading (in rad, as per veins::Heading).
+         */
+        static Rectangle fromHost(const Coord& position, double heading, double length, double hostPositionOffset, double width);
+
+        /**
+         * Return the four corners of this rectangle.
+         */
+        std::array<Coord, 4> getCorners() const;
+
+        bool containsPoint(const Coord& point) const;
+
+        /**
+         * return closest point (in meters) along (senderPos--receiverPos) where this rectangle overlaps, or NAN if it doesn't
+         */
+        double getIntersectionPoint(const Coord& senderPos, const Coord& receiverPos) const;
+    };
+
     MobileHostObstacle(std::vector<AntennaPosition> initialAntennaPositions, BaseMobility* mobility, double length, double hostPositionOffset, double width, double height)
         : initialAntennaPositions(std::move(initialAntennaPositions))
         , mobility(mobility)
@@ -53,18 +86,22 @@ public:
     void setMobility(BaseMobility* mobility)
     {
         this->mobility = mobility;
+        invalidateRectangle();
     }
     void setLength(double d)
     {
         this->length = d;
+        invalidateRectangle();
     }
     void setHostPositionOffset(double d)
     {
         this->hostPositionOffset = d;
+        invalidateRectangle();
     }
     void setWidth(double d)
     {
         this->width = d;
+        invalidateRectangle();
     }
     void setHeight(double d)
     {
@@ -98,6 +135,21 @@ public:
 
     Coords getShape(simtime_t t) const;
 
+    /**
+     * return the footprint of this obstacle at time t
+     *
+     * The result is cached until it is requested for a different time or invalidateRectangle is called.
+     */
+    const Rectangle& getRectangle(simtime_t t) const;
+
+    /**
+     * discard the cached footprint, e.g., because the host's mobility state changed
+     */
+    void invalidateRectangle()
+    {
+        isRectangleValid = false;
+    }
+
     bool maybeInBounds(double x1, double y1, double x2, double y2, simtime_t t) const;
 
     /**
@@ -118,5 +170,9 @@ protected:
     double hostPositionOffset;
     double width;
     double height;
+
+    mutable Rectangle rectangle; /**< cached result of getRectangle */
+    mutable simtime_t rectangleTime; /**< time rectangle was computed for */
+    mutable bool isRectangleValid = false;
 };
 } // namespace veins
@@ -40,6 +40,23 @@ Obstacle::Obstacle(std::string id, std::string type, double attenuationPerCut, d
 void Obstacle::setShape(Coords shape)
 {
     coords = shape;
+
+    const size_t n = coords.size();
+    edges.fromX.resize(n);
+    edges.fromY.resize(n);
+    edges.toY.resize(n);
+    edges.dirX.resize(n);
+    edges.dirY.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const Coord& c1 = coords[k];
+        const Coord& c2 = coords[(k + n - 1) % n];
+        edges.fromX[k] = c1.x;
+        edges.fromY[k] = c1.y;
+        edges.toY[k] = c2.y;
+        edges.dirX[k] = c2.x - c1.x;
+        edges.dirY[k] = c2.y - c1.y;
+    }
+
     bboxP1 = Coord(1e7, 1e7);
     bboxP2 = Coord(-1e7, -1e7);
     for (Coords::const_iterator i = coords.begin(); i != coords.end(); ++i) {
@@ -67,61 +84,69 @@ const Coord Obstacle::getBboxP2() const
 
 bool Obstacle::containsPoint(Coord point) const
 {
-    bool isInside = false;
-    const Obstacle::Coords& shape = getShape();
-    Obstacle::Coords::const_iterator i = shape.begin();
-    Obstacle::Coords::const_iterator j = (shape.rbegin() + 1).base();
-    for (; i != shape.end(); j = i++) {
-        bool inYRangeUp = (point.y >= i->y) && (point.y < j->y);
-        bool inYRangeDown = (point.y >= j->y) && (point.y < i->y);
-        bool inYRange = inYRangeUp || inYRangeDown;
-        if (!inYRange) continue;
-        bool intersects = point.x < (i->x + ((point.y - i->y) * (j->x - i->x) / (j->y - i->y)));
-        if (!intersects) continue;
-        isInside = !isInside;
+    // count crossings of a ray from point towards +x with the polygon's edges (branch-free, so the loop can be vectorized)
+    const size_t n = edges.fromX.size();
+    const double* fromX = edges.fromX.data();
+    const double* fromY = edges.fromY.data();
+    const double* toY = edges.toY.data();
+    const double* dirX = edges.dirX.data();
+    const double* dirY = edges.dirY.data();
+    const double x = point.x;
+    const double y = point.y;
+    uint64_t crossings = 0;
+    for (size_t k = 0; k < n; ++k) {
+        // y in [fromY, toY) or in [toY, fromY)
+        const uint64_t inYRange = uint64_t(y >= fromY[k]) ^ uint64_t(y >= toY[k]);
+        const uint64_t intersects = x < (fromX[k] + ((y - fromY[k]) * dirX[k] / dirY[k]));
+        crossings += inYRange & intersects;
     }
-    return isInside;
+    return (crossings % 2) == 1;
 }
 
-namespace {
-
-double segmentsIntersectAt(const Coord& p1From, const Coord& p1To, const Coord& p2From, const Coord& p2To)
+std::vector<double> Obstacle::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
 {
-    double p1x = p1To.x - p1From.x;
-    double p1y = p1To.y - p1From.y;
-    double p2x = p2To.x - p2From.x;
-    double p2y = p2To.y - p2From.y;
-    double p1p2x = p1From.x - p2From.x;
-    double p1p2y = p1From.y - p2From.y;
-    double D = (p1x * p2y - p1y * p2x);
-
-    double p1Frac = (p2x * p1p2y - p2y * p1p2x) / D;
-    if (p1Frac < 0 || p1Frac > 1) return -1;
+    std::vector<double> intersectAt(getNumEdges());
+    intersectAt.resize(getIntersections(senderPos, receiverPos, intersectAt.data()));
+    return intersectAt;
+}
 
-    double p2Frac = (p1x * p1p2y - p1y * p1p2x) / D;
-    if (p2Frac < 0 || p2Frac > 1) return -1;
+size_t Obstacle::getIntersections(const Coord& senderPos, const Coord& receiverPos, double* intersectAt) const
+{
+    const size_t n = edges.fromX.size();
+    const double* fromX = edges.fromX.data();
+    const double* fromY = edges.fromY.data();
+    const double* dirX = edges.dirX.data();
+    const double* dirY = edges.dirY.data();
+    const double senderX = senderPos.x;
+    const double senderY = senderPos.y;
+    const double p1x = receiverPos.x - senderX;
+    const double p1y = receiverPos.y - senderY;
+
+    // pass 1: intersect the beam with all edges at once (branch-free, so the loop can be vectorized), marking misses as -1
+    for (size_t k = 0; k < n; ++k) {
+        const double p2x = dirX[k];
+        const double p2y = dirY[k];
+        const double p1p2x = senderX - fromX[k];
+        const double p1p2y = senderY - fromY[k];
+        const double D = (p1x * p2y - p1y * p2x);
+        const double p1Frac = (p2x * p1p2y - p2y * p1p2x) / D;
+        const double p2Frac = (p1x * p1p2y - p1y * p1p2x) / D;
+        const bool miss = (p1Frac < 0) | (p1Frac > 1) | (p2Frac < 0) | (p2Frac > 1);
+        intersectAt[k] = miss ? -1 : p1Frac;
+    }
 
-    return p1Frac;
+    // pass 2: drop misses
+    size_t count = 0;
+    for (size_t k = 0; k < n; ++k) {
+        if (intersectAt[k] != -1) intersectAt[count++] = intersectAt[k];
+    }
+    std::sort(intersectAt, intersectAt + count);
+    return count;
 }
-} // namespace
 
-std::vector<double> Obstacle::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
+size_t Obstacle::getNumEdges() const
 {
-    std::vector<double> intersectAt;
-    const Obstacle::Coords& shape = getShape();
-    Obstacle::Coords::const_iterator i = shape.begin();
-    Obstacle::Coords::const_iterator j = (shape.rbegin() + 1).base();
-    for (; i != shape.end(); j = i++) {
-        const Coord& c1 = *i;
-        const Coord& c2 = *j;
-
-        double i = segmentsIntersectAt(senderPos, receiverPos, c1, c2);
-        if (i != -1) {
-            intersectAt.push_back(i);
-        }
-    }
-    std::sort(intersectAt.begin(), intersectAt.end());
-    return intersectAt;
+    return edges.fromX.size();
 }
 
 std::string Obstacle::getType() const
@@ -56,6 +56,19 @@ public:
      */
     std::vector<double> getIntersections(const Coord& senderPos, const Coord& receiverPos) const;
 
+    /**
+     * like getIntersections, but write the (sorted) points to a caller-provided buffer instead of allocating a new vector
+     *
+     * @param intersectAt buffer with room for at least getNumEdges() values
+     * @return number of points written
+     */
+    size_t getIntersections(const Coord& senderPos, const Coord& receiverPos, double* intersectAt) const;
+
+    /**
+     * get number of edges of this obstacle, i.e., the maximum number of points returned by getIntersections
+     */
+    size_t getNumEdges() const;
+
     AnnotationManager::Annotation* visualRepresentation;
 
 protected:
@@ -66,6 +79,17 @@ protected:
     Coords coords;
     Coord bboxP1;
     Coord bboxP2;
+
+    /**
+     * edges of the polygon in struct-of-arrays form (from vertex k to vertex k-1), so many edges can be tested at once
+     */
+    struct Edges {
+        std::vector<double> fromX;
+        std::vector<double> fromY;
+        std::vector<double> toY;
+        std::vector<double> dirX;
+        std::vector<double> dirY;
+    } edges;
 };
 
 } // namespace veins
@@ -20,12 +20,16 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <algorithm>
 #include <sstream>
 #include <map>
 #include <set>
 
 #include "veins/modules/obstacle/ObstacleControl.h"
+#include "veins/modules/obstacle/PolygonFile.h"
 #include "veins/base/modules/BaseWorldUtility.h"
+#include "veins/base/connectionManager/ChannelAccess.h"
+#include "veins/base/utils/FindModule.h"
 
 using veins::ObstacleControl;
 
@@ -33,14 +37,41 @@ Define_Module(veins::ObstacleControl);
 
 namespace {
 
-veins::BBoxLookup rebuildBBoxLookup(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner, int gridCellSize = 250)
+veins::BBoxLookup::Box obstacleBBox(veins::Obstacle* o)
+{
+    return veins::BBoxLookup::Box{{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}};
+}
+
+std::vector<veins::Obstacle*> obstaclePointers(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner)
 {
     std::vector<veins::Obstacle*> obstaclePointers;
     obstaclePointers.reserve(obstacleOwner.size());
     std::transform(obstacleOwner.begin(), obstacleOwner.end(), std::back_inserter(obstaclePointers), [](const std::unique_ptr<veins::Obstacle>& obstacle) { return obstacle.get(); });
+    return obstaclePointers;
+}
+
+veins::BBoxLookup rebuildBBoxLookup(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner, int gridCellSize = 250)
+{
     auto playgroundSize = veins::FindModule<veins::BaseWorldUtility*>::findGlobalModule()->getPgs();
-    auto bboxFunction = [](veins::Obstacle* o) { return veins::BBoxLookup::Box{{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}}; };
-    return veins::BBoxLookup(obstaclePointers, bboxFunction, playgroundSize->x, playgroundSize->y, gridCellSize);
+    return veins::BBoxLookup(obstaclePointers(obstacleOwner), obstacleBBox, playgroundSize->x, playgroundSize->y, gridCellSize);
+}
+
+veins::BBoxTree rebuildBBoxTree(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner)
+{
+    return veins::BBoxTree(obstaclePointers(obstacleOwner), obstacleBBox);
+}
+
+/**
+ * FNV-1a hash of a sequence of bytes.
+ */
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
 }
 
 } // anonymous namespace
@@ -53,7 +84,6 @@ void ObstacleControl::initialize(int stage)
 {
     if (stage == 1) {
         obstacleOwner.clear();
-        cacheEntries.clear();
         isBboxLookupDirty = true;
 
         annotations = AnnotationManagerAccess().getIfExists();
@@ -65,12 +95,61 @@ void ObstacleControl::initialize(int stage)
             throw cRuntimeError("gridCellSize was %d, but must be a positive integer number", gridCellSize);
         }
 
+        int cacheSize = par("attenuationCacheSize");
+        double cacheQuantization = par("attenuationCacheQuantization");
+        if (cacheSize < 0) {
+            throw cRuntimeError("attenuationCacheSize was %d, but must not be negative", cacheSize);
+        }
+        if (cacheQuantization < 0) {
+            throw cRuntimeError("attenuationCacheQuantization was %f, but must not be negative", cacheQuantization);
+        }
+        cache = AttenuationCache(cacheSize, cacheQuantization);
+
+        int attenuationThreads = par("attenuationThreads");
+        if (attenuationThreads < 0) {
+            throw cRuntimeError("attenuationThreads was %d, but must not be negative", attenuationThreads);
+        }
+        if ((attenuationThreads > 0) && (cacheSize == 0)) {
+            throw cRuntimeError("attenuationThreads was %d, but precalculated attenuation is handed to receivers via the cache, which is disabled (attenuationCacheSize is 0)", attenuationThreads);
+        }
+        threadPool.reset(attenuationThreads > 0 ? new ThreadPool(attenuationThreads) : nullptr);
+
+        useRayTraversal = par("useRayTraversal");
+        std::string obstacleIndexPar = par("obstacleIndex").stdstringValue();
+        if (obstacleIndexPar == "grid") {
+            obstacleIndex = ObstacleIndex::grid;
+        }
+        else if (obstacleIndexPar == "tree") {
+            obstacleIndex = ObstacleIndex::tree;
+        }
+        else {
+            throw cRuntimeError("obstacleIndex was \"%s\", but must be \"grid\" or \"tree\"", obstacleIndexPar.c_str());
+        }
+
+        polygonCacheDirectory = par("polygonCacheDirectory").stdstringValue();
+
+        cStringTokenizer shadowingMapNodesTokenizer(par("shadowingMapNodes").stringValue());
+        shadowingMapNodes = shadowingMapNodesTokenizer.asVector();
+        shadowingMapDirectory = par("shadowingMapDirectory").stdstringValue();
+        shadowingMapResolution = par("shadowingMapResolution");
+        if (shadowingMapResolution <= 0) {
+            throw cRuntimeError("shadowingMapResolution was %f, but must be positive", shadowingMapResolution);
+        }
+        shadowingMaps.clear();
+        areShadowingMapsComputed = false;
+        obstaclesAfterShadowingMaps.clear();
+        obstaclesErasedFromShadowingMaps.clear();
+
         addFromXml(obstaclesXml);
     }
 }
 
 void ObstacleControl::finish()
 {
+    if (cache.getCapacity() > 0) {
+        recordScalar("attenuationCacheHits", cache.getNumHits());
+        recordScalar("attenuationCacheMisses", cache.getNumMisses());
+    }
     obstacleOwner.clear();
 }
 
@@ -130,13 +209,7 @@ void ObstacleControl::addFromXml(cXMLElement* xml)
 
             Obstacle obs(id, type, getAttenuationPerCut(type), getAttenuationPerMeter(type));
             std::vector<Coord> sh;
-            cStringTokenizer st(shape.c_str());
-            while (st.hasMoreTokens()) {
-                std::string xy = st.nextToken();
-                std::vector<double> xya = cStringTokenizer(xy.c_str(), ",").asDoubleVector();
-                ASSERT(xya.size() == 2);
-                sh.push_back(Coord(xya[0], xya[1]));
-            }
+            PolygonFile::parseShape(shape.data(), shape.data() + shape.size(), sh);
             obs.setShape(sh);
             add(obs);
         }
@@ -156,6 +229,26 @@ void ObstacleControl::addFromTypeAndShape(std::string id, std::string typeId, st
     add(obs);
 }
 
+void ObstacleControl::addFromPolygonFile(const std::string& fileName, std::function<Coord(const Coord&)> toOmnet)
+{
+    std::vector<PolygonFile::Polygon> polygons = PolygonFile::read(fileName, polygonCacheDirectory);
+
+    auto playgroundSize = FindModule<BaseWorldUtility*>::findGlobalModule()->getPgs();
+    obstacleOwner.reserve(obstacleOwner.size() + polygons.size());
+    for (auto& polygon : polygons) {
+        if (!isTypeSupported(polygon.type)) continue;
+        for (auto& p : polygon.shape) {
+            p = toOmnet(p);
+            if ((p.x < 0) || (p.y < 0) || (p.x > playgroundSize->x) || (p.y > playgroundSize->y)) {
+                EV_WARN << "WARNING: Playground (" << playgroundSize->x << ", " << playgroundSize->y << ") will not fit radio obstacle at (" << p.x << ", " << p.y << ")" << endl;
+            }
+        }
+        Obstacle obs(polygon.id, polygon.type, getAttenuationPerCut(polygon.type), getAttenuationPerMeter(polygon.type));
+        obs.setShape(std::move(polygon.shape));
+        add(obs);
+    }
+}
+
 void ObstacleControl::add(Obstacle obstacle)
 {
     Obstacle* o = new Obstacle(obstacle);
@@ -164,49 +257,58 @@ void ObstacleControl::add(Obstacle obstacle)
     // visualize using AnnotationManager
     if (annotations) o->visualRepresentation = annotations->drawPolygon(o->getShape(), "red", annotationGroup);
 
-    cacheEntries.clear();
-    isBboxLookupDirty = true;
+    cache.clear();
+    if (areShadowingMapsComputed) obstaclesAfterShadowingMaps.push_back(o);
+    if (obstacleIndex == ObstacleIndex::tree && !isBboxLookupDirty) {
+        // update tree in place instead of rebuilding it for the next query
+        bboxTree.insert(o, obstacleBBox(o));
+    }
+    else {
+        isBboxLookupDirty = true;
+    }
 }
 
 void ObstacleControl::erase(const Obstacle* obstacle)
 {
     if (annotations && obstacle->visualRepresentation) annotations->erase(obstacle->visualRepresentation);
+    if (obstacleIndex == ObstacleIndex::tree && !isBboxLookupDirty) {
+        bboxTree.erase(const_cast<Obstacle*>(obstacle));
+    }
+    // obstacles that are part of the shadowing maps are kept, so their links can be recognized
+    bool isInShadowingMaps = areShadowingMapsComputed;
+    if (isInShadowingMaps) {
+        auto itAfter = std::find(obstaclesAfterShadowingMaps.begin(), obstaclesAfterShadowingMaps.end(), obstacle);
+        if (itAfter != obstaclesAfterShadowingMaps.end()) {
+            obstaclesAfterShadowingMaps.erase(itAfter);
+            isInShadowingMaps = false;
+        }
+    }
     for (auto itOwner = obstacleOwner.begin(); itOwner != obstacleOwner.end(); ++itOwner) {
         // find owning pointer and remove it to deallocate obstacle
         if (itOwner->get() == obstacle) {
+            if (isInShadowingMaps) obstaclesErasedFromShadowingMaps.push_back(std::move(*itOwner));
             obstacleOwner.erase(itOwner);
             break;
         }
     }
 
-    cacheEntries.clear();
-    isBboxLookupDirty = true;
+    cache.clear();
+    if (obstacleIndex != ObstacleIndex::tree) isBboxLookupDirty = true;
 }
 
 std::vector<std::pair<veins::Obstacle*, std::vector<double>>> ObstacleControl::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
 {
     std::vector<std::pair<Obstacle*, std::vector<double>>> allIntersections;
 
-    // rebuild bounding box lookup structure if dirty (new obstacles added recently)
-    if (isBboxLookupDirty) {
-        bboxLookup = rebuildBBoxLookup(obstacleOwner);
-        isBboxLookupDirty = false;
-    }
-
-    auto candidateObstacles = bboxLookup.findOverlapping({senderPos.x, senderPos.y}, {receiverPos.x, receiverPos.y});
-
-    // remove duplicates
-    sort(candidateObstacles.begin(), candidateObstacles.end());
-    candidateObstacles.erase(unique(candidateObstacles.begin(), candidateObstacles.end()), candidateObstacles.end());
-
-    for (Obstacle* o : candidateObstacles) {
+    forEachCandidate(senderPos, receiverPos, [&](Obstacle* o) -> bool {
         // if obstacles has neither borders nor matter: bail.
-        if (o->getShape().size() < 2) continue;
+        if (o->getShape().size() < 2) return true;
         auto foundIntersections = o->getIntersections(senderPos, receiverPos);
         if (!foundIntersections.empty() || o->containsPoint(senderPos) || o->containsPoint(receiverPos)) {
             allIntersections.emplace_back(o, foundIntersections);
         }
-    }
+        return true;
+    });
     return allIntersections;
 }
 
@@ -221,56 +323,240 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
         throw cRuntimeError("Unable to use SimpleObstacleShadowing: No obstacles have been added");
     }
 
+    // use precomputed attenuation for links to fixed nodes, if available
+    if (!shadowingMapNodes.empty()) {
+        updateShadowingMaps();
+        double factor;
+        if (lookupShadowingMaps(senderPos, receiverPos, factor)) return factor;
+    }
+
     // return cached result, if available
-    CacheKey cacheKey(senderPos, receiverPos);
-    CacheEntries::const_iterator cacheEntryIter = cacheEntries.find(cacheKey);
-    if (cacheEntryIter != cacheEntries.end()) {
-        return cacheEntryIter->second;
+    double cachedFactor;
+    if (cache.find(senderPos, receiverPos, cachedFactor)) {
+        return cachedFactor;
+    }
+
+    double factor = calculateUncachedAttenuation(senderPos, receiverPos);
+
+    // cache result
+    cache.insert(senderPos, receiverPos, factor);
+
+    return factor;
+}
+
+void ObstacleControl::precalculateAttenuation(const std::vector<std::pair<Coord, Coord>>& links) const
+{
+    Enter_Method_Silent();
+
+    if (!threadPool || obstacleOwner.empty()) return;
+
+    // everything that is not thread-safe needs to be done up front
+    updateBBoxLookup();
+    if (!shadowingMapNodes.empty()) updateShadowingMaps();
+
+    // skip links that are covered by shadowing maps or already cached
+    pendingLinks.clear();
+    for (size_t i = 0; i < links.size(); ++i) {
+        const Coord& senderPos = links[i].first;
+        const Coord& receiverPos = links[i].second;
+        double factor;
+        if (lookupShadowingMaps(senderPos, receiverPos, factor) || cache.contains(senderPos, receiverPos)) continue;
+        pendingLinks.push_back(i);
     }
 
-    // get intersections
-    auto intersections = getIntersections(senderPos, receiverPos);
+    pendingFactors.resize(pendingLinks.size());
+    threadPool->parallelFor(pendingLinks.size(), [&](size_t k) {
+        const auto& link = links[pendingLinks[k]];
+        pendingFactors[k] = calculateUncachedAttenuation(link.first, link.second);
+    });
+
+    for (size_t k = 0; k < pendingLinks.size(); ++k) {
+        const auto& link = links[pendingLinks[k]];
+        cache.insert(link.first, link.second, pendingFactors[k]);
+    }
+}
 
+double ObstacleControl::calculateUncachedAttenuation(const Coord& senderPos, const Coord& receiverPos) const
+{
     double factor = 1;
-    for (auto i = intersections.begin(); i != intersections.end(); ++i) {
-        auto o = i->first;
-        auto intersectAt = i->second;
-
-        // if beam interacts with neither borders nor matter: bail.
-        bool senderInside = o->containsPoint(senderPos);
-        bool receiverInside = o->containsPoint(receiverPos);
-        if ((intersectAt.size() == 0) && !senderInside && !receiverInside) continue;
-
-        // remember number of cuts before messing with intersection points
-        double numCuts = intersectAt.size();
-
-        // for distance calculation, make sure every other pair of points marks transition through matter and void, respectively.
-        if (senderInside) intersectAt.insert(intersectAt.begin(), 0);
-        if (receiverInside) intersectAt.push_back(1);
-        ASSERT((intersectAt.size() % 2) == 0);
-
-        // sum up distances in matter.
-        double fractionInObstacle = 0;
-        for (auto i = intersectAt.begin(); i != intersectAt.end();) {
-            double p1 = *(i++);
-            double p2 = *(i++);
-            fractionInObstacle += (p2 - p1);
+    forEachCandidate(senderPos, receiverPos, [&](Obstacle* o) -> bool {
+        // if obstacles has neither borders nor matter: bail.
+        if (o->getShape().size() < 2) return true;
+        factor *= calculateObstacleAttenuation(*o, senderPos, receiverPos);
+
+        // bail if attenuation is already extremely high
+        return factor >= 1e-30;
+    });
+    return factor;
+}
+
+uint64_t ObstacleControl::getObstacleHash() const
+{
+    // combine hashes of individual obstacles by summing them up, so the order obstacles were added in does not matter
+    uint64_t hash = 0;
+    for (const auto& o : obstacleOwner) {
+        double attenuation[2] = {o->getAttenuationPerCut(), o->getAttenuationPerMeter()};
+        uint64_t obstacleHash = fnv1a(attenuation, sizeof(attenuation));
+        for (const auto& c : o->getShape()) {
+            double xy[2] = {c.x, c.y};
+            obstacleHash = fnv1a(xy, sizeof(xy), obstacleHash);
         }
+        hash += obstacleHash;
+    }
+    return hash;
+}
 
-        // calculate attenuation
-        double totalDistance = senderPos.distance(receiverPos);
-        double attenuation = (o->getAttenuationPerCut() * numCuts) + (o->getAttenuationPerMeter() * fractionInObstacle * totalDistance);
-        factor *= pow(10.0, -attenuation / 10.0);
+void ObstacleControl::updateShadowingMaps() const
+{
+    if (areShadowingMapsComputed) return;
+    areShadowingMapsComputed = true;
+
+    const uint64_t obstacleHash = getObstacleHash();
+    const Coord* playgroundSize = FindModule<BaseWorldUtility*>::findGlobalModule()->getPgs();
+    const size_t numCols = static_cast<size_t>(std::ceil(playgroundSize->x / shadowingMapResolution)) + 1;
+    const size_t numRows = static_cast<size_t>(std::ceil(playgroundSize->y / shadowingMapResolution)) + 1;
+
+    // calculateUncachedAttenuation needs an up to date bounding box lookup to be thread-safe
+    updateBBoxLookup();
+
+    for (const auto& path : shadowingMapNodes) {
+        cModule* node = findModuleByPath(path.c_str());
+        if (!node) throw cRuntimeError("Could not find fixed node \"%s\" listed in shadowingMapNodes", path.c_str());
+        auto channelAccesses = FindModule<ChannelAccess*>::findSubModules(node);
+        if (channelAccesses.empty()) throw cRuntimeError("Fixed node \"%s\" listed in shadowingMapNodes has no channel access (i.e., phy layer) module", path.c_str());
+
+        // one map per antenna (links are calculated between antenna positions, which include the antenna offset)
+        for (auto channelAccess : channelAccesses) {
+            const Coord position = channelAccess->getAntennaPosition().getPositionAt();
+            if (std::any_of(shadowingMaps.begin(), shadowingMaps.end(), [&](const std::unique_ptr<ShadowingMap>& map) { return map->isAt(position); })) continue;
+
+            std::string fileName = shadowingMapDirectory + "/shadowingmap-" + std::to_string(obstacleHash) + "-" + std::to_string(position.x) + "-" + std::to_string(position.y) + "-" + std::to_string(shadowingMapResolution) + ".bin";
+            auto map = ShadowingMap::load(fileName, position, shadowingMapResolution, obstacleHash);
+            if (map) {
+                EV_INFO << "Loaded shadowing map for " << path << " from " << fileName << endl;
+            }
+            else {
+                EV_INFO << "Computing shadowing map for " << path << " (" << numCols << " x " << numRows << " points)" << endl;
+                map.reset(new ShadowingMap(position, shadowingMapResolution, numCols, numRows, obstacleHash));
+                ShadowingMap& newMap = *map;
+                auto computeRow = [&](size_t row) {
+                    for (size_t col = 0; col < numCols; ++col) {
+                        const Coord point(col * shadowingMapResolution, row * shadowingMapResolution, position.z);
+                        const double factor = calculateUncachedAttenuation(position, point);
+                        newMap.set(col, row, -10 * std::log10(std::max(factor, 1e-100)));
+                    }
+                };
+                if (threadPool) {
+                    threadPool->parallelFor(numRows, computeRow);
+                }
+                else {
+                    for (size_t row = 0; row < numRows; ++row) computeRow(row);
+                }
+                map->save(fileName);
+            }
+            shadowingMaps.push_back(std::move(map));
+        }
+    }
+}
 
-        // bail if attenuation is already extremely high
-        if (factor < 1e-30) break;
+bool ObstacleControl::lookupShadowingMaps(const Coord& senderPos, const Coord& receiverPos, double& factor) const
+{
+    bool isCovered = false;
+    for (const auto& map : shadowingMaps) {
+        if ((map->isAt(senderPos) && map->lookup(receiverPos, factor)) || (map->isAt(receiverPos) && map->lookup(senderPos, factor))) {
+            isCovered = true;
+            break;
+        }
     }
+    if (!isCovered) return false;
 
-    // cache result
-    if (cacheEntries.size() >= 1000) cacheEntries.clear();
-    cacheEntries[cacheKey] = factor;
+    // the common case: obstacles have not changed since the maps were computed
+    if (obstaclesErasedFromShadowingMaps.empty() && obstaclesAfterShadowingMaps.empty()) return true;
 
-    return factor;
+    // the maps still include erased obstacles, so links crossing one of them need to be calculated
+    for (const auto& o : obstaclesErasedFromShadowingMaps) {
+        if (o->getShape().size() < 2) continue;
+        if (calculateObstacleAttenuation(*o, senderPos, receiverPos) != 1) return false;
+    }
+
+    // obstacles added since are not part of the maps
+    for (auto o : obstaclesAfterShadowingMaps) {
+        if (o->getShape().size() < 2) continue;
+        factor *= calculateObstacleAttenuation(*o, senderPos, receiverPos);
+    }
+    return true;
+}
+
+double ObstacleControl::calculateObstacleAttenuation(const Obstacle& o, const Coord& senderPos, const Coord& receiverPos) const
+{
+    // get intersections, leaving room for one point before and after them
+    static thread_local std::vector<double> intersectionBuffer;
+    if (intersectionBuffer.size() < o.getNumEdges() + 2) intersectionBuffer.resize(o.getNumEdges() + 2);
+    double* intersectAt = intersectionBuffer.data() + 1;
+    size_t numCuts = o.getIntersections(senderPos, receiverPos, intersectAt);
+
+    // if beam interacts with neither borders nor matter: bail.
+    bool senderInside = o.containsPoint(senderPos);
+    bool receiverInside = o.containsPoint(receiverPos);
+    if ((numCuts == 0) && !senderInside && !receiverInside) return 1;
+
+    // for distance calculation, make sure every other pair of points marks transition through matter and void, respectively.
+    double* begin = intersectAt;
+    double* end = intersectAt + numCuts;
+    if (senderInside) *(--begin) = 0;
+    if (receiverInside) *(end++) = 1;
+    ASSERT(((end - begin) % 2) == 0);
+
+    // sum up distances in matter.
+    double fractionInObstacle = 0;
+    for (double* i = begin; i != end;) {
+        double p1 = *(i++);
+        double p2 = *(i++);
+        fractionInObstacle += (p2 - p1);
+    }
+
+    // calculate attenuation
+    double totalDistance = senderPos.distance(receiverPos);
+    double attenuation = (o.getAttenuationPerCut() * numCuts) + (o.getAttenuationPerMeter() * fractionInObstacle * totalDistance);
+    return pow(10.0, -attenuation / 10.0);
+}
+
+void ObstacleControl::updateBBoxLookup() const
+{
+    if (!isBboxLookupDirty) return;
+    if (obstacleIndex == ObstacleIndex::tree) {
+        bboxTree = rebuildBBoxTree(obstacleOwner);
+    }
+    else {
+        bboxLookup = rebuildBBoxLookup(obstacleOwner, gridCellSize);
+    }
+    isBboxLookupDirty = false;
+}
+
+void ObstacleControl::forEachCandidate(const Coord& senderPos, const Coord& receiverPos, const std::function<bool(Obstacle*)>& visit) const
+{
+    updateBBoxLookup();
+
+    const BBoxLookup::Point sender{senderPos.x, senderPos.y};
+    const BBoxLookup::Point receiver{receiverPos.x, receiverPos.y};
+    if (obstacleIndex == ObstacleIndex::tree) {
+        bboxTree.traverse(sender, receiver, visit);
+        return;
+    }
+    if (useRayTraversal) {
+        bboxLookup.traverse(sender, receiver, visit);
+        return;
+    }
+
+    auto candidateObstacles = bboxLookup.findOverlapping(sender, receiver);
+
+    // remove duplicates
+    sort(candidateObstacles.begin(), candidateObstacles.end());
+    candidateObstacles.erase(unique(candidateObstacles.begin(), candidateObstacles.end()), candidateObstacles.end());
+
+    for (Obstacle* o : candidateObstacles) {
+        if (!visit(o)) return;
+    }
 }
 
 double ObstacleControl::getAttenuationPerCut(std::string type)
@@ -22,14 +22,19 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "veins/veins.h"
 
 #include "veins/base/utils/Coord.h"
 #include "veins/modules/obstacle/Obstacle.h"
+#include "veins/modules/obstacle/AttenuationCache.h"
+#include "veins/modules/obstacle/ShadowingMap.h"
 #include "veins/modules/world/annotations/AnnotationManager.h"
 #include "veins/modules/utility/BBoxLookup.h"
+#include "veins/modules/utility/BBoxTree.h"
+#include "veins/modules/utility/ThreadPool.h"
 
 namespace veins {
 
@@ -54,6 +59,13 @@ public:
 
     void addFromXml(cXMLElement* xml);
     void addFromTypeAndShape(std::string id, std::string typeId, std::vector<Coord> shape);
+
+    /**
+     * add all polygons of supported types from a SUMO polygon file (.poly.xml), converting their coordinates with toOmnet
+     *
+     * Parsed polygons are cached in polygonCacheDirectory (if set).
+     */
+    void addFromPolygonFile(const std::string& fileName, std::function<Coord(const Coord&)> toOmnet);
     void add(Obstacle obstacle);
     void erase(const Obstacle* obstacle);
     bool isTypeSupported(std::string type);
@@ -70,43 +82,94 @@ public:
      */
     double calculateAttenuation(const Coord& senderPos, const Coord& receiverPos) const;
 
+    /**
+     * return whether precalculateAttenuation is enabled (i.e., worker threads have been configured)
+     */
+    bool isPrecalculatingAttenuation() const
+    {
+        return threadPool != nullptr;
+    }
+
+    /**
+     * calculate additional attenuation by obstacles for many links (pairs of sender and receiver positions) in parallel, storing the results in the cache for later calls to calculateAttenuation
+     */
+    void precalculateAttenuation(const std::vector<std::pair<Coord, Coord>>& links) const;
+
 protected:
-    struct CacheKey {
-        const Coord senderPos;
-        const Coord receiverPos;
-
-        CacheKey(const Coord& senderPos, const Coord& receiverPos)
-            : senderPos(senderPos)
-            , receiverPos(receiverPos)
-        {
-        }
-
-        bool operator<(const CacheKey& o) const
-        {
-            if (senderPos.x < o.senderPos.x) return true;
-            if (senderPos.x > o.senderPos.x) return false;
-            if (senderPos.y < o.senderPos.y) return true;
-            if (senderPos.y > o.senderPos.y) return false;
-            if (receiverPos.x < o.receiverPos.x) return true;
-            if (receiverPos.x > o.receiverPos.x) return false;
-            if (receiverPos.y < o.receiverPos.y) return true;
-            if (receiverPos.y > o.receiverPos.y) return false;
-            return false;
-        }
+    /**
+     * spatial index used to find obstacles touched by a transmission
+     */
+    enum class ObstacleIndex {
+        grid, /**< BBoxLookup, rebuilt whenever obstacles are added or erased */
+        tree, /**< BBoxTree, updated in place */
     };
 
-    typedef std::map<CacheKey, double> CacheEntries;
+    /**
+     * rebuild bounding box lookup structure if dirty (new obstacles added recently)
+     */
+    void updateBBoxLookup() const;
+
+    /**
+     * call visit for every obstacle whose bounding box is touched by the line between sender and receiver (once per obstacle), until it returns false
+     */
+    void forEachCandidate(const Coord& senderPos, const Coord& receiverPos, const std::function<bool(Obstacle*)>& visit) const;
+
+    /**
+     * calculate additional attenuation by obstacles without using precomputed or cached results, return multiplicative factor
+     *
+     * Safe to call concurrently from multiple threads, as long as the bounding box lookup is up to date (see updateBBoxLookup).
+     */
+    double calculateUncachedAttenuation(const Coord& senderPos, const Coord& receiverPos) const;
+
+    /**
+     * get a hash of all obstacles (independent of the order they were added in), to tell whether precomputed results still apply
+     */
+    uint64_t getObstacleHash() const;
+
+    /**
+     * load or compute shadowing maps for all antennas of fixed nodes, if not done yet
+     *
+     * Maps are computed using the thread pool, if enabled. They cover the obstacles present at this time. Obstacles added or erased later are accounted for by lookupShadowingMaps instead.
+     */
+    void updateShadowingMaps() const;
+
+    /**
+     * look up the attenuation of a link to a fixed node in the shadowing maps, return false if no map covers it
+     *
+     * Applies obstacles added since the maps were computed, and returns false for links crossing an obstacle erased since then.
+     */
+    bool lookupShadowingMaps(const Coord& senderPos, const Coord& receiverPos, double& factor) const;
+
+    /**
+     * calculate attenuation by a single obstacle on the line between sender and receiver, return multiplicative factor
+     */
+    double calculateObstacleAttenuation(const Obstacle& o, const Coord& senderPos, const Coord& receiverPos) const;
 
     cXMLElement* obstaclesXml; /**< obstacles to add at startup */
     int gridCellSize = 250; /**< size of square grid tiles for obstacle store */
+    bool useRayTraversal = false; /**< only search grid tiles crossed by the line between sender and receiver */
+    ObstacleIndex obstacleIndex = ObstacleIndex::grid;
 
     std::vector<std::unique_ptr<Obstacle>> obstacleOwner;
     AnnotationManager* annotations;
     AnnotationManager::Group* annotationGroup;
     std::map<std::string, double> perCut;
     std::map<std::string, double> perMeter;
-    mutable CacheEntries cacheEntries;
+    mutable AttenuationCache cache; /**< attenuation factors of recently calculated links */
     mutable BBoxLookup bboxLookup;
+    mutable BBoxTree bboxTree;
+    std::unique_ptr<ThreadPool> threadPool; /**< workers for precalculateAttenuation (if enabled) */
+    mutable std::vector<size_t> pendingLinks; /**< links precalculateAttenuation needs to compute */
+    mutable std::vector<double> pendingFactors; /**< results for pendingLinks */
+
+    std::vector<std::string> shadowingMapNodes; /**< module paths of fixed nodes to precompute attenuation for */
+    std::string polygonCacheDirectory; /**< where to store parsed polygon files */
+    std::string shadowingMapDirectory; /**< where to store precomputed shadowing maps */
+    double shadowingMapResolution; /**< distance between points of shadowing maps */
+    mutable std::vector<std::unique_ptr<ShadowingMap>> shadowingMaps;
+    mutable bool areShadowingMapsComputed = false;
+    std::vector<const Obstacle*> obstaclesAfterShadowingMaps; /**< obstacles added after the shadowing maps were computed (not part of them) */
+    std::vector<std::unique_ptr<Obstacle>> obstaclesErasedFromShadowingMaps; /**< obstacles part of the shadowing maps, but erased since */
     mutable bool isBboxLookupDirty = true;
 };
 
@@ -0,0 +1,338 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/modules/obstacle/PolygonFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
+#define VEINS_POLYGONFILE_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace veins {
+
+namespace {
+
+const char magic[8] = {'V', 'E', 'I', 'N', 'S', 'P', 'O', 'L'};
+
+/** per polygon in a cache file: sizes of the data that follows */
+struct Record {
+    uint32_t idLength;
+    uint32_t typeLength;
+    uint32_t numPoints;
+};
+
+bool isSpace(char c)
+{
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+const char* skipSpace(const char* p, const char* end)
+{
+    while (p != end && isSpace(*p)) ++p;
+    return p;
+}
+
+bool equals(const char* begin, const char* end, const char* s)
+{
+    const size_t length = std::strlen(s);
+    return (static_cast<size_t>(end - begin) == length) && (std::memcmp(begin, s, length) == 0);
+}
+
+bool startsWith(const char* begin, const char* end, const char* s)
+{
+    const size_t length = std::strlen(s);
+    return (static_cast<size_t>(end - begin) >= length) && (std::memcmp(begin, s, length) == 0);
+}
+
+/**
+ * Return the value of an XML attribute, replacing predefined entities and (ASCII) character references.
+ */
+std::string decodeAttribute(const char* begin, const char* end)
+{
+    if (std::find(begin, end, '&') == end) return std::string(begin, end);
+
+    std::string value;
+    for (const char* p = begin; p != end;) {
+        if (*p != '&') {
+            value += *(p++);
+            continue;
+        }
+        const char* semicolon = std::find(p, end, ';');
+        if (semicolon == end) throw cRuntimeError("Malformed entity in polygon file attribute \"%s\"", std::string(begin, end).c_str());
+        const char* name = p + 1;
+        if (equals(name, semicolon, "amp")) value += '&';
+        else if (equals(name, semicolon, "lt")) value += '<';
+        else if (equals(name, semicolon, "gt")) value += '>';
+        else if (equals(name, semicolon, "quot")) value += '"';
+        else if (equals(name, semicolon, "apos")) value += '\'';
+        else if (startsWith(name, semicolon, "#x")) value += static_cast<char>(std::strtol(name + 2, nullptr, 16));
+        else if (startsWith(name, semicolon, "#")) value += static_cast<char>(std::strtol(name + 1, nullptr, 10));
+        else throw cRuntimeError("Unknown entity in polygon file attribute \"%s\"", std::string(begin, end).c_str());
+        p = semicolon + 1;
+    }
+    return value;
+}
+
+} // namespace
+
+const uint32_t PolygonFile::formatVersion;
+
+std::vector<PolygonFile::Polygon> PolygonFile::read(const std::string& fileName, const std::string& cacheDirectory)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file) throw cRuntimeError("Could not open polygon file \"%s\"", fileName.c_str());
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const char* begin = content.data();
+    const char* end = content.data() + content.size();
+
+    const uint64_t contentHash = hash(begin, end);
+    std::string cacheFileName = cacheDirectory + "/polygons-" + std::to_string(contentHash) + ".bin";
+
+    std::vector<Polygon> polygons;
+    if (!cacheDirectory.empty() && loadCache(cacheFileName, contentHash, polygons)) return polygons;
+
+    polygons = parse(begin, end);
+    if (!cacheDirectory.empty()) saveCache(cacheFileName, contentHash, polygons);
+    return polygons;
+}
+
+std::vector<PolygonFile::Polygon> PolygonFile::parse(const char* begin, const char* end)
+{
+    std::vector<Polygon> polygons;
+
+    auto malformed = [begin](const char* p) {
+        return cRuntimeError("Malformed polygon file at byte %ld", static_cast<long>(p - begin));
+    };
+
+    for (const char* p = std::find(begin, end, '<'); p != end; p = std::find(p, end, '<')) {
+        ++p;
+
+        // skip comments (which may contain tags), as well as declarations, processing instructions, and end tags
+        if (startsWith(p, end, "!--")) {
+            static const char commentEnd[] = "-->";
+            p = std::search(p, end, commentEnd, commentEnd + 3);
+            if (p == end) throw malformed(p);
+            continue;
+        }
+        if ((p != end) && ((*p == '!') || (*p == '?') || (*p == '/'))) continue;
+
+        // only look at poly elements
+        const char* nameEnd = std::find_if(p, end, [](char c) { return isSpace(c) || (c == '/') || (c == '>'); });
+        if (!equals(p, nameEnd, "poly")) {
+            p = nameEnd;
+            continue;
+        }
+        p = nameEnd;
+
+        // <poly id="building#0" type="building" color="#F00" shape="16,0 8,13.8564 -8,13.8564" />
+        Polygon polygon;
+        bool hasId = false;
+        bool hasShape = false;
+        bool isGeo = false;
+        while (true) {
+            p = skipSpace(p, end);
+            if (p == end) throw malformed(p);
+            if ((*p == '/') || (*p == '>')) break;
+
+            const char* attributeName = p;
+            p = std::find_if(p, end, [](char c) { return isSpace(c) || (c == '='); });
+            const char* attributeNameEnd = p;
+            p = skipSpace(p, end);
+            if ((p == end) || (*p != '=')) throw malformed(p);
+            p = skipSpace(p + 1, end);
+            if ((p == end) || ((*p != '"') && (*p != '\''))) throw malformed(p);
+            const char* value = p + 1;
+            const char* valueEnd = std::find(value, end, *p);
+            if (valueEnd == end) throw malformed(p);
+
+            if (equals(attributeName, attributeNameEnd, "id")) {
+                polygon.id = decodeAttribute(value, valueEnd);
+                hasId = true;
+            }
+            else if (equals(attributeName, attributeNameEnd, "type")) {
+                polygon.type = decodeAttribute(value, valueEnd);
+            }
+            else if (equals(attributeName, attributeNameEnd, "shape")) {
+                parseShape(value, valueEnd, polygon.shape);
+                hasShape = true;
+            }
+            else if (equals(attributeName, attributeNameEnd, "geo")) {
+                isGeo = equals(value, valueEnd, "1") || equals(value, valueEnd, "true");
+            }
+            p = valueEnd + 1;
+        }
+
+        if (!hasId || !hasShape) throw malformed(p);
+        if (isGeo) throw cRuntimeError("Polygon \"%s\" uses geo-coordinates, which are not supported", polygon.id.c_str());
+        polygons.push_back(std::move(polygon));
+    }
+
+    return polygons;
+}
+
+void PolygonFile::parseShape(const char* begin, const char* end, std::vector<Coord>& shape)
+{
+    auto malformed = [begin, end]() {
+        return cRuntimeError("Malformed shape \"%s\"", std::string(begin, end).c_str());
+    };
+
+    const char* p = skipSpace(begin, end);
+    while (p != end) {
+        // x,y or x,y,z -- strtod stops at the first character that cannot continue a number, so it never reads past end as long as *end does not
+        double c[3];
+        size_t numCoordinates = 0;
+        while (true) {
+            char* next;
+            c[numCoordinates++] = std::strtod(p, &next);
+            if ((next == p) || (next > end)) throw malformed();
+            p = next;
+            if ((p == end) || (*p != ',') || (numCoordinates == 3)) break;
+            ++p;
+        }
+        if (numCoordinates < 2) throw malformed();
+        if ((p != end) && !isSpace(*p)) throw malformed();
+        shape.emplace_back(c[0], c[1]);
+        p = skipSpace(p, end);
+    }
+}
+
+uint64_t PolygonFile::hash(const char* begin, const char* end)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char* p = begin; p != end; ++p) {
+        hash ^= static_cast<unsigned char>(*p);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool PolygonFile::loadCache(const std::string& path, uint64_t contentHash, std::vector<Polygon>& polygons)
+{
+#ifndef VEINS_POLYGONFILE_NO_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+    const size_t size = st.st_size;
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+    const char* data = static_cast<const char*>(mapping);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const size_t size = content.size();
+    const char* data = content.data();
+    if (size < sizeof(Header)) return false;
+#endif
+
+    // read records one by one, checking every size against the remaining data
+    bool isValid = true;
+    std::vector<Polygon> loaded;
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if ((std::memcmp(header.magic, magic, sizeof(magic)) != 0) || (header.version != formatVersion) || (header.contentHash != contentHash)) {
+        isValid = false;
+    }
+    size_t offset = sizeof(Header);
+    for (uint64_t i = 0; isValid && (i < header.numPolygons); ++i) {
+        Record record;
+        if (size - offset < sizeof(Record)) {
+            isValid = false;
+            break;
+        }
+        std::memcpy(&record, data + offset, sizeof(Record));
+        offset += sizeof(Record);
+        const size_t dataSize = size_t(record.idLength) + record.typeLength + size_t(record.numPoints) * 2 * sizeof(double);
+        if (size - offset < dataSize) {
+            isValid = false;
+            break;
+        }
+
+        Polygon polygon;
+        polygon.id.assign(data + offset, record.idLength);
+        offset += record.idLength;
+        polygon.type.assign(data + offset, record.typeLength);
+        offset += record.typeLength;
+        polygon.shape.reserve(record.numPoints);
+        for (uint32_t k = 0; k < record.numPoints; ++k) {
+            double xy[2];
+            std::memcpy(xy, data + offset, sizeof(xy));
+            offset += sizeof(xy);
+            polygon.shape.emplace_back(xy[0], xy[1]);
+        }
+        loaded.push_back(std::move(polygon));
+    }
+    if (offset != size) isValid = false;
+
+#ifndef VEINS_POLYGONFILE_NO_MMAP
+    munmap(mapping, size);
+#endif
+
+    if (!isValid) return false;
+    polygons = std::move(loaded);
+    return true;
+}
+
+void PolygonFile::saveCache(const std::string& path, uint64_t contentHash, const std::vector<Polygon>& polygons)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = formatVersion;
+    header.reserved = 0;
+    header.contentHash = contentHash;
+    header.numPolygons = polygons.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    for (const auto& polygon : polygons) {
+        Record record{static_cast<uint32_t>(polygon.id.size()), static_cast<uint32_t>(polygon.type.size()), static_cast<uint32_t>(polygon.shape.size())};
+        file.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+        file.write(polygon.id.data(), polygon.id.size());
+        file.write(polygon.type.data(), polygon.type.size());
+        for (const auto& point : polygon.shape) {
+            double xy[2] = {point.x, point.y};
+            file.write(reinterpret_cast<const char*>(xy), sizeof(xy));
+        }
+    }
+
+    if (!file) throw cRuntimeError("Could not write polygon cache to \"%s\"", path.c_str());
+}
+
+} // namespace veins
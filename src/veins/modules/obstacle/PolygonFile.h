@@ -0,0 +1,104 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+
+namespace veins {
+
+/**
+ * Reader for polygons in SUMO polygon files (.poly.xml), with an optional binary cache.
+ *
+ * Parsing is done in a single pass over the raw file content, only looking at poly elements and their id, type, and shape attributes.
+ * Coordinates are returned as found in the file (i.e., in SUMO coordinates); geo-referenced polygons are not supported.
+ *
+ * Parsed polygons can be saved to a binary cache file and memory-mapped when loaded again.
+ * A cache file starts with a 32 byte header (magic, format version, a hash of the polygon file's content, and the number of polygons),
+ * followed by, for each polygon, the lengths of its id and type and its number of points (as 32 bit integers), the id and type, and the points (as pairs of doubles), in native byte order.
+ * Cache files whose header does not match the polygon file's content are ignored.
+ *
+ * @see ObstacleControl
+ */
+class VEINS_API PolygonFile {
+public:
+    static const uint32_t formatVersion = 1;
+
+    struct Polygon {
+        std::string id;
+        std::string type;
+        std::vector<Coord> shape;
+    };
+
+    /**
+     * Read all polygons from a SUMO polygon file, throwing a cRuntimeError if it cannot be read or parsed.
+     *
+     * If cacheDirectory is not empty, polygons are loaded from a cache file there (if one exists for the file's content), or a new cache file is written.
+     */
+    static std::vector<Polygon> read(const std::string& fileName, const std::string& cacheDirectory = "");
+
+    /**
+     * Parse all polygons from the content of a SUMO polygon file, throwing a cRuntimeError if it is malformed.
+     */
+    static std::vector<Polygon> parse(const char* begin, const char* end);
+
+    /**
+     * Parse a shape given as space-separated coordinates (e.g., "0,0 10,0 10,10"), appending its points to shape.
+     *
+     * A third (z) coordinate per point is accepted, but ignored.
+     * Throws a cRuntimeError if the shape is malformed.
+     */
+    static void parseShape(const char* begin, const char* end, std::vector<Coord>& shape);
+
+    /**
+     * Return the FNV-1a hash of a sequence of bytes (e.g., a polygon file's content).
+     */
+    static uint64_t hash(const char* begin, const char* end);
+
+    /**
+     * Load polygons from a cache file, returning false if it does not exist or does not match contentHash.
+     */
+    static bool loadCache(const std::string& path, uint64_t contentHash, std::vector<Polygon>& polygons);
+
+    /**
+     * Write polygons to a cache file, throwing a cRuntimeError on failure.
+     */
+    static void saveCache(const std::string& path, uint64_t contentHash, const std::vector<Polygon>& polygons);
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t contentHash;
+        uint64_t numPolygons;
+    };
+    static_assert(sizeof(Header) == 32, "PolygonFile cache header must be 32 bytes");
+};
+
+} // namespace veins
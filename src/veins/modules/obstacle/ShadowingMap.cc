@@ -0,0 +1,190 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/modules/obstacle/ShadowingMap.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
+#define VEINS_SHADOWINGMAP_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace veins {
+
+namespace {
+
+const char magic[8] = {'V', 'E', 'I', 'N', 'S', 'S', 'H', 'M'};
+
+/** maximum distance (in m, ignoring heights) at which a position is considered the fixed position of a map */
+const double positionTolerance = 0.01;
+
+} // namespace
+
+const uint32_t ShadowingMap::formatVersion;
+
+ShadowingMap::ShadowingMap(const Coord& position, double resolution, size_t numCols, size_t numRows, uint64_t obstacleHash)
+    : position(position)
+    , ownedValues(numCols * numRows, 0)
+{
+    ASSERT(resolution > 0);
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = formatVersion;
+    header.numCols = numCols;
+    header.numRows = numRows;
+    header.reserved = 0;
+    header.obstacleHash = obstacleHash;
+    header.x = position.x;
+    header.y = position.y;
+    header.z = position.z;
+    header.resolution = resolution;
+    values = ownedValues.data();
+}
+
+ShadowingMap::~ShadowingMap()
+{
+#ifndef VEINS_SHADOWINGMAP_NO_MMAP
+    if (mapping) munmap(mapping, mappingSize);
+#endif
+}
+
+std::unique_ptr<ShadowingMap> ShadowingMap::load(const std::string& path, const Coord& position, double resolution, uint64_t obstacleHash)
+{
+    std::unique_ptr<ShadowingMap> map(new ShadowingMap());
+
+#ifndef VEINS_SHADOWINGMAP_NO_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return nullptr;
+    map->mapping = mapping;
+    map->mappingSize = st.st_size;
+    std::memcpy(&map->header, mapping, sizeof(Header));
+    size_t dataSize = st.st_size - sizeof(Header);
+    // values are never written to after loading
+    map->values = reinterpret_cast<float*>(static_cast<char*>(mapping) + sizeof(Header));
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return nullptr;
+    if (!file.read(reinterpret_cast<char*>(&map->header), sizeof(Header))) return nullptr;
+    map->ownedValues.assign(size_t(map->header.numCols) * map->header.numRows, 0);
+    file.read(reinterpret_cast<char*>(map->ownedValues.data()), map->ownedValues.size() * sizeof(float));
+    size_t dataSize = file.gcount();
+    map->values = map->ownedValues.data();
+#endif
+
+    const Header& h = map->header;
+    if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) return nullptr;
+    if (h.version != formatVersion) return nullptr;
+    if (h.obstacleHash != obstacleHash) return nullptr;
+    if (h.resolution != resolution) return nullptr;
+    if (h.x != position.x || h.y != position.y || h.z != position.z) return nullptr;
+    if (dataSize != size_t(h.numCols) * h.numRows * sizeof(float)) return nullptr;
+
+    map->position = Coord(h.x, h.y, h.z);
+    return map;
+}
+
+void ShadowingMap::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char*>(values), size_t(header.numCols) * header.numRows * sizeof(float));
+    if (!file) throw cRuntimeError("Could not write shadowing map to \"%s\"", path.c_str());
+}
+
+void ShadowingMap::set(size_t col, size_t row, float attenuation_dB)
+{
+    ASSERT(!mapping);
+    ASSERT(col < header.numCols && row < header.numRows);
+    values[row * header.numCols + col] = attenuation_dB;
+}
+
+float ShadowingMap::get(size_t col, size_t row) const
+{
+    ASSERT(col < header.numCols && row < header.numRows);
+    return values[row * header.numCols + col];
+}
+
+bool ShadowingMap::lookup(const Coord& pos, double& factor) const
+{
+    const double fx = pos.x / header.resolution;
+    const double fy = pos.y / header.resolution;
+    if (!(fx >= 0 && fy >= 0)) return false;
+    size_t col = static_cast<size_t>(fx);
+    size_t row = static_cast<size_t>(fy);
+    if (col + 1 >= header.numCols || row + 1 >= header.numRows) return false;
+
+    // bilinear interpolation in dB
+    const double dx = fx - col;
+    const double dy = fy - row;
+    const float* r0 = values + row * header.numCols + col;
+    const float* r1 = r0 + header.numCols;
+    const double attenuation = (1 - dy) * ((1 - dx) * r0[0] + dx * r0[1]) + dy * ((1 - dx) * r1[0] + dx * r1[1]);
+    factor = pow(10.0, -attenuation / 10.0);
+    return true;
+}
+
+bool ShadowingMap::isAt(const Coord& pos) const
+{
+    return std::abs(pos.x - position.x) <= positionTolerance && std::abs(pos.y - position.y) <= positionTolerance;
+}
+
+const Coord& ShadowingMap::getPosition() const
+{
+    return position;
+}
+
+double ShadowingMap::getResolution() const
+{
+    return header.resolution;
+}
+
+size_t ShadowingMap::getNumCols() const
+{
+    return header.numCols;
+}
+
+size_t ShadowingMap::getNumRows() const
+{
+    return header.numRows;
+}
+
+bool ShadowingMap::isMapped() const
+{
+    return mapping != nullptr;
+}
+
+} // namespace veins
@@ -0,0 +1,127 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+
+namespace veins {
+
+/**
+ * Precomputed raster of obstacle attenuation between a fixed position and all points of the playground.
+ *
+ * Values are stored in dB for points spaced by the resolution of the map, starting at (0, 0).
+ * Attenuation to any point inside the raster is interpolated bilinearly, which is exact on the raster points and approximates attenuation in between,
+ * i.e., errors grow with the resolution and close to obstacle borders.
+ * Heights are ignored.
+ *
+ * Maps can be saved to a binary file and memory-mapped when loaded again, so they cost neither computation nor a copy at startup.
+ * A file starts with a 64 byte header (magic, format version, raster size, a hash of the obstacles it was computed for, the fixed position, and the resolution),
+ * followed by the raster as 32 bit floats, row by row, in native byte order.
+ * Files whose header does not match the expected version, obstacles, position, or resolution are rejected.
+ *
+ * @see ObstacleControl
+ */
+class VEINS_API ShadowingMap {
+public:
+    static const uint32_t formatVersion = 1;
+
+    /**
+     * Create an empty map (i.e., without attenuation) to be filled with set().
+     */
+    ShadowingMap(const Coord& position, double resolution, size_t numCols, size_t numRows, uint64_t obstacleHash);
+    ~ShadowingMap();
+
+    ShadowingMap(const ShadowingMap&) = delete;
+    ShadowingMap& operator=(const ShadowingMap&) = delete;
+
+    /**
+     * Load a map from a file, returning nullptr if the file does not exist or does not match the given parameters.
+     */
+    static std::unique_ptr<ShadowingMap> load(const std::string& path, const Coord& position, double resolution, uint64_t obstacleHash);
+
+    /**
+     * Write this map to a file, throwing a cRuntimeError on failure.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * Set the attenuation (in dB) between the fixed position and raster point (col * resolution, row * resolution).
+     */
+    void set(size_t col, size_t row, float attenuation_dB);
+
+    /**
+     * Return the attenuation (in dB) between the fixed position and raster point (col * resolution, row * resolution).
+     */
+    float get(size_t col, size_t row) const;
+
+    /**
+     * Look up the attenuation between the fixed position and pos as a multiplicative factor.
+     *
+     * @return false if pos is outside of the raster, true and set factor otherwise
+     */
+    bool lookup(const Coord& pos, double& factor) const;
+
+    /**
+     * Return whether pos is the fixed position of this map (ignoring heights).
+     */
+    bool isAt(const Coord& pos) const;
+
+    const Coord& getPosition() const;
+    double getResolution() const;
+    size_t getNumCols() const;
+    size_t getNumRows() const;
+    bool isMapped() const;
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t numCols;
+        uint32_t numRows;
+        uint32_t reserved;
+        uint64_t obstacleHash;
+        double x;
+        double y;
+        double z;
+        double resolution;
+    };
+    static_assert(sizeof(Header) == 64, "ShadowingMap file header must be 64 bytes");
+
+    ShadowingMap() = default;
+
+    Header header;
+    Coord position;
+    float* values = nullptr; /**< either points into ownedValues or into the mapped file */
+    std::vector<float> ownedValues;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+};
+
+} // namespace veins
@@ -20,6 +20,7 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <algorithm>
 #include <sstream>
 #include <map>
 #include <set>
@@ -31,6 +32,7 @@
 #include "veins/base/modules/BaseMobility.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
 #include "veins/base/toolbox/Signal.h"
+#include "veins/modules/utility/BBoxLookup.h"
 
 using veins::MobileHostObstacle;
 using veins::Signal;
@@ -42,6 +44,15 @@ VehicleObstacleControl::~VehicleObstacleControl() = default;
 
 void VehicleObstacleControl::initialize(int stage)
 {
+    if (stage == 0) {
+        useSpatialGrid = par("useSpatialGrid");
+        gridCellSize = par("gridCellSize");
+        if (useSpatialGrid && !(gridCellSize > 0)) {
+            throw cRuntimeError("gridCellSize was %f, but must be positive", gridCellSize);
+        }
+        // mobility state changes are emitted by the hosts' mobility modules and propagate up to the system module
+        getSimulation()->getSystemModule()->subscribe(BaseMobility::mobilityStateChangedSignal, this);
+    }
     if (stage == 1) {
         annotations = AnnotationManagerAccess().getIfExists();
         if (annotations) {
@@ -52,6 +63,7 @@ void VehicleObstacleControl::initialize(int stage)
 
 void VehicleObstacleControl::finish()
 {
+    getSimulation()->getSystemModule()->unsubscribe(BaseMobility::mobilityStateChangedSignal, this);
 }
 
 void VehicleObstacleControl::handleMessage(cMessage* msg)
@@ -68,10 +80,23 @@ void VehicleObstacleControl::handleSelfMsg(cMessage* msg)
     throw cRuntimeError("VehicleObstacleControl doesn't handle self-messages");
 }
 
+void VehicleObstacleControl::receiveSignal(cComponent* source, simsignal_t signalID, cObject* obj, cObject* details)
+{
+    if (signalID == BaseMobility::mobilityStateChangedSignal) {
+        vehicleGrid.dirty = true;
+        auto range = vehicleObstaclesByMobility.equal_range(source);
+        for (auto i = range.first; i != range.second; ++i) {
+            i->second->invalidateRectangle();
+        }
+    }
+}
+
 const MobileHostObstacle* VehicleObstacleControl::add(MobileHostObstacle obstacle)
 {
     auto* o = new MobileHostObstacle(obstacle);
     vehicleObstacles.push_back(o);
+    vehicleObstaclesByMobility.emplace(o->getMobility(), o);
+    vehicleGrid.dirty = true;
 
     return o;
 }
@@ -90,36 +115,29 @@ void VehicleObstacleControl::erase(const MobileHostObstacle* obstacle)
         }
     }
     ASSERT(erasedOne);
-    delete obstacle;
-}
-
-Signal VehicleObstacleControl::getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, Signal attenuationPrototype)
-{
-    Signal attenuation = Signal(attenuationPrototype.getSpectrum());
-
-    for (uint16_t i = 0; i < attenuation.getNumValues(); i++) {
-        double freq = attenuation.getSpectrum().freqAt(i);
-        double lambda = BaseWorldUtility::speedOfLight() / freq;
-        double d2 = d - d1;
-        double y = (h2 - h1) / d * d1 + h1;
-        double H = h - y;
-        double r1 = sqrt(lambda * d1 * d2 / d);
-        double V0 = sqrt(2) * H / r1;
-
-        if (V0 <= -0.7) {
-            attenuation.at(i) = 0;
+    auto range = vehicleObstaclesByMobility.equal_range(obstacle->getMobility());
+    for (auto i = range.first; i != range.second;) {
+        if (i->second == obstacle) {
+            i = vehicleObstaclesByMobility.erase(i);
         }
         else {
-            attenuation.at(i) = 6.9 + 20 * log10(sqrt(pow((V0 - 0.1), 2) + 1) + V0 - 0.1);
+            ++i;
         }
     }
-
-    return attenuation;
+    vehicleGrid.dirty = true;
+    delete obstacle;
 }
 
-Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, Signal attenuationPrototype)
-{
+namespace {
 
+/**
+ * Run the multiple knife-edge diffraction model of getVehicleAttenuationDZ, independent of how attenuation is stored.
+ *
+ * Calls addSingle(h1, h2, h, d, d1) for every obstacle that contributes to the attenuation and returns the correction term c (in dB) to add to their sum.
+ */
+template <typename AddSingle>
+double multipleKnifeEdgeDiffraction(const std::vector<std::pair<double, double>>& dz_vec, AddSingle addSingle)
+{
     // basic sanity check
     ASSERT(dz_vec.size() >= 2);
 
@@ -166,7 +184,6 @@ Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pa
     mo.push_back(dz_vec.size() - 1);
 
     // calculate attenuation due to MOs
-    Signal attenuation_mo(attenuationPrototype.getSpectrum());
     for (size_t mm = 0; mm < mo.size() - 2; ++mm) {
         size_t tx = mo[mm];
         size_t ob = mo[mm + 1];
@@ -178,13 +195,10 @@ Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pa
         double d1 = dz_vec[ob].first - dz_vec[tx].first;
         double h = dz_vec[ob].second;
 
-        Signal ad_mo = getVehicleAttenuationSingle(h1, h2, h, d, d1, attenuationPrototype);
-
-        attenuation_mo += ad_mo;
+        addSingle(h1, h2, h, d, d1);
     }
 
     // calculate attenuation due to "small obstacles" (i.e. the ones in-between MOs)
-    Signal attenuation_so(attenuationPrototype.getSpectrum());
     for (size_t i = 0; i < mo.size() - 1; ++i) {
         size_t delta = mo[i + 1] - mo[i];
 
@@ -203,8 +217,7 @@ Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pa
             double d1 = dz_vec[ob].first - dz_vec[tx].first;
             double h = dz_vec[ob].second;
 
-            Signal ad_mo = getVehicleAttenuationSingle(h1, h2, h, d, d1, attenuationPrototype);
-            attenuation_so += ad_mo;
+            addSingle(h1, h2, h, d, d1);
         }
         else {
             // multiple obstacles in-between these two MOs -- use the one closest to their line of sight
@@ -240,8 +253,7 @@ Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pa
             double d1 = dz_vec[ob].first - dz_vec[tx].first;
             double h = dz_vec[ob].second;
 
-            Signal ad_mo = getVehicleAttenuationSingle(h1, h2, h, d, d1, attenuationPrototype);
-            attenuation_so += ad_mo;
+            addSingle(h1, h2, h, d, d1);
         }
     }
 
@@ -270,7 +282,128 @@ Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pa
         c = -10 * log10((prodS * sumS) / (prodSsum * firstS * lastS));
     }
 
-    return attenuation_mo + attenuation_so + c;
+    return c;
+}
+
+/**
+ * Tabulated knife-edge diffraction loss J(v) = 6.9 + 20 log10(sqrt((v - 0.1)^2 + 1) + v - 0.1) (ITU-R P.526).
+ *
+ * As J(v) = 6.9 + 20 / ln(10) * asinh(v - 0.1), its second derivative is bounded by 20 / ln(10) * 2 / (3 sqrt(3)) < 3.35,
+ * so linear interpolation with a step of 1/32 deviates from the exact value by at most 3.35 / 32^2 / 8 < 0.0005 dB.
+ * Beyond the table, J(v) is computed exactly.
+ */
+class KnifeEdgeLossTable {
+public:
+    KnifeEdgeLossTable()
+    {
+        values.resize(static_cast<size_t>((maxV - minV) * stepsPerUnit) + 2);
+        for (size_t k = 0; k < values.size(); ++k) {
+            values[k] = formula(minV + k / stepsPerUnit);
+        }
+    }
+
+    static double exact(double v)
+    {
+        if (v <= minV) return 0;
+        return formula(v);
+    }
+
+    double operator()(double v) const
+    {
+        if (v <= minV) return 0;
+        if (v >= maxV) return exact(v);
+        const double x = (v - minV) * stepsPerUnit;
+        const size_t k = static_cast<size_t>(x);
+        const double frac = x - k;
+        return values[k] + frac * (values[k + 1] - values[k]);
+    }
+
+private:
+    static double formula(double v)
+    {
+        return 6.9 + 20 * log10(sqrt(pow((v - 0.1), 2) + 1) + v - 0.1);
+    }
+
+    static constexpr double minV = -0.7;
+    static constexpr double maxV = 16;
+    static constexpr double stepsPerUnit = 32;
+    std::vector<double> values;
+};
+
+constexpr double KnifeEdgeLossTable::minV;
+constexpr double KnifeEdgeLossTable::maxV;
+constexpr double KnifeEdgeLossTable::stepsPerUnit;
+
+} // namespace
+
+Signal VehicleObstacleControl::getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, const Signal& attenuationPrototype)
+{
+    Signal attenuation(attenuationPrototype.getSpectrum());
+
+    for (uint16_t i = 0; i < attenuation.getNumValues(); i++) {
+        double freq = attenuation.getSpectrum().freqAt(i);
+        double lambda = BaseWorldUtility::speedOfLight() / freq;
+        double d2 = d - d1;
+        double y = (h2 - h1) / d * d1 + h1;
+        double H = h - y;
+        double r1 = sqrt(lambda * d1 * d2 / d);
+        double V0 = sqrt(2) * H / r1;
+
+        attenuation.at(i) = KnifeEdgeLossTable::exact(V0);
+    }
+
+    return attenuation;
+}
+
+Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, const Signal& attenuationPrototype)
+{
+    Signal attenuation(attenuationPrototype.getSpectrum());
+    double c = multipleKnifeEdgeDiffraction(dz_vec, [&](double h1, double h2, double h, double d, double d1) {
+        attenuation += getVehicleAttenuationSingle(h1, h2, h, d, d1, attenuationPrototype);
+    });
+    return std::move(attenuation) + c;
+}
+
+std::vector<double> VehicleObstacleControl::getInvSqrtWavelengths(const Spectrum& spectrum)
+{
+    std::vector<double> invSqrtWavelengths(spectrum.getNumFreqs());
+    for (size_t i = 0; i < invSqrtWavelengths.size(); ++i) {
+        double lambda = BaseWorldUtility::speedOfLight() / spectrum.freqAt(i);
+        invSqrtWavelengths[i] = 1 / sqrt(lambda);
+    }
+    return invSqrtWavelengths;
+}
+
+void VehicleObstacleControl::addVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, const double* invSqrtWavelengths, size_t numValues, double* attenuation, bool interpolateKnifeEdgeLoss)
+{
+    // V0 = sqrt(2) * H / sqrt(lambda * d1 * d2 / d), split into a frequency-independent factor and 1 / sqrt(lambda)
+    double d2 = d - d1;
+    double y = (h2 - h1) / d * d1 + h1;
+    double H = h - y;
+    double v = sqrt(2) * H * sqrt(d / (d1 * d2));
+
+    if (interpolateKnifeEdgeLoss) {
+        static const KnifeEdgeLossTable knifeEdgeLoss;
+        for (size_t i = 0; i < numValues; i++) {
+            attenuation[i] += knifeEdgeLoss(v * invSqrtWavelengths[i]);
+        }
+    }
+    else {
+        for (size_t i = 0; i < numValues; i++) {
+            attenuation[i] += KnifeEdgeLossTable::exact(v * invSqrtWavelengths[i]);
+        }
+    }
+}
+
+void VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, const double* invSqrtWavelengths, size_t numValues, double* attenuation, bool interpolateKnifeEdgeLoss)
+{
+    std::fill(attenuation, attenuation + numValues, 0.0);
+    double c = multipleKnifeEdgeDiffraction(dz_vec, [&](double h1, double h2, double h, double d, double d1) {
+        addVehicleAttenuationSingle(h1, h2, h, d, d1, invSqrtWavelengths, numValues, attenuation, interpolateKnifeEdgeLoss);
+    });
+    for (size_t i = 0; i < numValues; i++) {
+        attenuation[i] += c;
+    }
 }
 
 std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObstacles(const AntennaPosition& senderPos_, const AntennaPosition& receiverPos_, const Signal& s) const
@@ -303,7 +436,7 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
     double y1 = std::min(senderPos.y, receiverPos.y);
     double y2 = std::max(senderPos.y, receiverPos.y);
 
-    for (auto o : vehicleObstacles) {
+    auto checkVehicle = [&](MobileHostObstacle* o) {
         auto obstacleAntennaPositions = o->getInitialAntennaPositions();
         double l = o->getLength();
         double w = o->getWidth();
@@ -315,7 +448,7 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
 
         if (!o->maybeInBounds(x1, y1, x2, y2, sStart)) {
             EV_TRACE << "bounding boxes don't overlap: ignore" << std::endl;
-            continue;
+            return;
         }
 
         // check if this is either the sender or the receiver
@@ -330,7 +463,7 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
                 ignoreMe = true;
             }
         }
-        if (ignoreMe) continue;
+        if (ignoreMe) return;
 
         // this is a potential obstacle
         double p1d = o->getIntersectionPoint(senderPos, receiverPos, sStart);
@@ -358,6 +491,18 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
                 annotations->drawLine(senderPos, hitPos, "red", vehicleAnnotationGroup);
             }
         }
+    };
+
+    if (useSpatialGrid) {
+        findGridCandidates(senderPos, receiverPos, sStart);
+        for (size_t i : candidates) {
+            checkVehicle(vehicleGrid.vehicles[i]);
+        }
+    }
+    else {
+        for (auto o : vehicleObstacles) {
+            checkVehicle(o);
+        }
     }
 
     return potentialObstacles;
@@ -369,3 +514,145 @@ void VehicleObstacleControl::drawVehicleObstacles(const simtime_t& t) const
         annotations->drawPolygon(o->getShape(t), "black", vehicleAnnotationGroup);
     }
 }
+
+void VehicleObstacleControl::updateVehicleGrid(simtime_t t) const
+{
+    VehicleGrid& g = vehicleGrid;
+
+    // vehicles can have moved at most maxSpeed * |t - builtAt| since the grid was built: keep using it while this is small compared to a cell
+    if (!g.dirty && (g.maxSpeed * std::abs(SIMTIME_DBL(t - g.builtAt)) <= g.cellSize / 2)) return;
+
+    g.vehicles.assign(vehicleObstacles.begin(), vehicleObstacles.end());
+    g.builtAt = t;
+    g.maxSpeed = 0;
+    g.dirty = false;
+
+    // bounding boxes of all vehicles, as used by MobileHostObstacle::maybeInBounds
+    std::vector<BBoxLookup::Box> boxes(g.vehicles.size());
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = std::numeric_limits<double>::infinity();
+    double maxX = -std::numeric_limits<double>::infinity();
+    double maxY = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < g.vehicles.size(); ++i) {
+        const MobileHostObstacle* o = g.vehicles[i];
+        const BaseMobility* m = o->getMobility();
+        Coord p = m->getPositionAt(t);
+        double r = std::abs(o->getHostPositionOffset()) + std::max(o->getLength(), o->getWidth() / 2);
+        boxes[i] = {{p.x - r, p.y - r}, {p.x + r, p.y + r}};
+        minX = std::min(minX, boxes[i].p1.x);
+        minY = std::min(minY, boxes[i].p1.y);
+        maxX = std::max(maxX, boxes[i].p2.x);
+        maxY = std::max(maxY, boxes[i].p2.y);
+        g.maxSpeed = std::max(g.maxSpeed, m->getCurrentSpeed().length());
+    }
+    if (g.vehicles.empty()) {
+        minX = minY = maxX = maxY = 0;
+    }
+
+    // grow cells if vehicles are spread out too far for the configured cell size
+    const size_t maxCells = 1 << 16;
+    g.cellSize = gridCellSize;
+    g.originX = minX;
+    g.originY = minY;
+    while (true) {
+        g.numCols = static_cast<size_t>(std::floor((maxX - minX) / g.cellSize)) + 1;
+        g.numRows = static_cast<size_t>(std::floor((maxY - minY) / g.cellSize)) + 1;
+        if (g.numCols * g.numRows <= maxCells) break;
+        g.cellSize *= 2;
+    }
+
+    auto cellRange = [&g](const BBoxLookup::Box& box, size_t& col1, size_t& row1, size_t& col2, size_t& row2) {
+        col1 = std::min(g.numCols - 1, static_cast<size_t>((box.p1.x - g.originX) / g.cellSize));
+        row1 = std::min(g.numRows - 1, static_cast<size_t>((box.p1.y - g.originY) / g.cellSize));
+        col2 = std::min(g.numCols - 1, static_cast<size_t>((box.p2.x - g.originX) / g.cellSize));
+        row2 = std::min(g.numRows - 1, static_cast<size_t>((box.p2.y - g.originY) / g.cellSize));
+    };
+
+    // counting sort of vehicles into cells: count entries per cell, turn counts into offsets, then fill
+    g.cellStart.assign(g.numCols * g.numRows + 1, 0);
+    for (const auto& box : boxes) {
+        size_t col1, row1, col2, row2;
+        cellRange(box, col1, row1, col2, row2);
+        for (size_t row = row1; row <= row2; ++row) {
+            for (size_t col = col1; col <= col2; ++col) {
+                ++g.cellStart[row * g.numCols + col + 1];
+            }
+        }
+    }
+    for (size_t c = 1; c < g.cellStart.size(); ++c) {
+        g.cellStart[c] += g.cellStart[c - 1];
+    }
+    g.entries.resize(g.cellStart.back());
+    std::vector<size_t> fill(g.cellStart.begin(), g.cellStart.end() - 1);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        size_t col1, row1, col2, row2;
+        cellRange(boxes[i], col1, row1, col2, row2);
+        for (size_t row = row1; row <= row2; ++row) {
+            for (size_t col = col1; col <= col2; ++col) {
+                g.entries[fill[row * g.numCols + col]++] = i;
+            }
+        }
+    }
+
+    visitStamps.assign(g.vehicles.size(), 0);
+    currentStamp = 0;
+}
+
+void VehicleObstacleControl::findGridCandidates(const Coord& senderPos, const Coord& receiverPos, simtime_t t) const
+{
+    updateVehicleGrid(t);
+    const VehicleGrid& g = vehicleGrid;
+
+    candidates.clear();
+    if (g.vehicles.empty()) return;
+
+    // inflate cells by how far vehicles might have moved since the grid was built (plus some slack for rounding)
+    const double margin = g.maxSpeed * std::abs(SIMTIME_DBL(t - g.builtAt)) * (1 + 1e-9) + 1e-6;
+
+    // cells overlapping the bounding box of the line of sight
+    const double x1 = std::min(senderPos.x, receiverPos.x) - margin;
+    const double x2 = std::max(senderPos.x, receiverPos.x) + margin;
+    const double y1 = std::min(senderPos.y, receiverPos.y) - margin;
+    const double y2 = std::max(senderPos.y, receiverPos.y) + margin;
+    if ((x2 < g.originX) || (y2 < g.originY) || (x1 > g.originX + g.numCols * g.cellSize) || (y1 > g.originY + g.numRows * g.cellSize)) return;
+    const size_t col1 = static_cast<size_t>(std::max(0.0, (x1 - g.originX) / g.cellSize));
+    const size_t row1 = static_cast<size_t>(std::max(0.0, (y1 - g.originY) / g.cellSize));
+    const size_t col2 = std::min(g.numCols - 1, static_cast<size_t>((x2 - g.originX) / g.cellSize));
+    const size_t row2 = std::min(g.numRows - 1, static_cast<size_t>((y2 - g.originY) / g.cellSize));
+
+    // of these, only search cells (inflated by margin) that the line of sight passes through, i.e., whose corners are not all strictly on one side of it
+    const double dx = receiverPos.x - senderPos.x;
+    const double dy = receiverPos.y - senderPos.y;
+    auto side = [&](double x, double y) {
+        return dx * (y - senderPos.y) - dy * (x - senderPos.x);
+    };
+
+    if (++currentStamp == 0) {
+        std::fill(visitStamps.begin(), visitStamps.end(), 0);
+        currentStamp = 1;
+    }
+    for (size_t row = row1; row <= row2; ++row) {
+        const double cy1 = g.originY + row * g.cellSize - margin;
+        const double cy2 = g.originY + (row + 1) * g.cellSize + margin;
+        for (size_t col = col1; col <= col2; ++col) {
+            const double cx1 = g.originX + col * g.cellSize - margin;
+            const double cx2 = g.originX + (col + 1) * g.cellSize + margin;
+            const double s1 = side(cx1, cy1);
+            const double s2 = side(cx2, cy1);
+            const double s3 = side(cx1, cy2);
+            const double s4 = side(cx2, cy2);
+            if ((s1 > 0 && s2 > 0 && s3 > 0 && s4 > 0) || (s1 < 0 && s2 < 0 && s3 < 0 && s4 < 0)) continue;
+
+            const size_t cell = row * g.numCols + col;
+            for (size_t e = g.cellStart[cell]; e < g.cellStart[cell + 1]; ++e) {
+                const size_t i = g.entries[e];
+                if (visitStamps[i] == currentStamp) continue;
+                visitStamps[i] = currentStamp;
+                candidates.push_back(i);
+            }
+        }
+    }
+
+    // check candidates in the same order as without the grid, so results (e.g., which of two obstacles at the same distance is kept) are identical
+    std::sort(candidates.begin(), candidates.end());
+}
@@ -23,6 +23,8 @@
 #pragma once
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -36,6 +38,7 @@
 namespace veins {
 
 class Signal;
+class Spectrum;
 
 /**
  * VehicleObstacleControl models moving obstacles that block radio transmissions.
@@ -44,7 +47,7 @@ class Signal;
  * Transmissions that cross one of the polygon's lines will have
  * their receive power set to zero.
  */
-class VEINS_API VehicleObstacleControl : public cSimpleModule {
+class VEINS_API VehicleObstacleControl : public cSimpleModule, public cListener {
 public:
     ~VehicleObstacleControl() override;
     void initialize(int stage) override;
@@ -55,6 +58,7 @@ public:
     void finish() override;
     void handleMessage(cMessage* msg) override;
     void handleSelfMsg(cMessage* msg);
+    void receiveSignal(cComponent* source, simsignal_t signalID, cObject* obj, cObject* details) override;
 
     const MobileHostObstacle* add(MobileHostObstacle obstacle);
     void erase(const MobileHostObstacle* obstacle);
@@ -76,7 +80,7 @@ public:
      * @param d1: distance between sender and obstacle
      * @param attenuationPrototype: a prototype Signal for constructing a Signal containing the attenuation factors for each frequency
      */
-    static Signal getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, Signal attenuationPrototype);
+    static Signal getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, const Signal& attenuationPrototype);
 
     /**
      * compute attenuation due to vehicles.
@@ -86,15 +90,81 @@ public:
      * @param dz_vec: a vector of (distance, height) referring to potential obstacles along the line of sight, starting with the sender and ending with the receiver
      * @param attenuationPrototype: a prototype Signal for constructing a Signal containing the attenuation factors for each frequency
      */
-    static Signal getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, Signal attenuationPrototype);
+    static Signal getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, const Signal& attenuationPrototype);
+
+    /**
+     * return 1 / sqrt(lambda) for the wavelength lambda of each frequency in spectrum, for use with the array-based versions of getVehicleAttenuationSingle and getVehicleAttenuationDZ
+     */
+    static std::vector<double> getInvSqrtWavelengths(const Spectrum& spectrum);
+
+    /**
+     * compute attenuation due to (single) vehicle, adding it (in dB) to attenuation.
+     *
+     * Same model as getVehicleAttenuationSingle, but working on flat arrays of numValues entries.
+     * The diffraction parameter is computed in a different order, so results differ from getVehicleAttenuationSingle by floating-point rounding (less than 1e-12 dB).
+     *
+     * @param invSqrtWavelengths: 1 / sqrt(lambda) for each frequency (see getInvSqrtWavelengths)
+     * @param interpolateKnifeEdgeLoss: interpolate the knife-edge diffraction loss from a table instead of computing it exactly, deviating from the exact value by less than 0.0005 dB
+     */
+    static void addVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, const double* invSqrtWavelengths, size_t numValues, double* attenuation, bool interpolateKnifeEdgeLoss = false);
+
+    /**
+     * compute attenuation due to vehicles, writing it (in dB) to attenuation.
+     *
+     * Same model as getVehicleAttenuationDZ, but working on flat arrays of numValues entries without allocating temporary Signals.
+     * Results differ from getVehicleAttenuationDZ by floating-point rounding only (less than 1e-12 dB per obstacle, see addVehicleAttenuationSingle).
+     *
+     * @param invSqrtWavelengths: 1 / sqrt(lambda) for each frequency (see getInvSqrtWavelengths)
+     * @param interpolateKnifeEdgeLoss: see addVehicleAttenuationSingle; results then deviate from the exact value by less than 0.0005 dB per obstacle
+     */
+    static void getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, const double* invSqrtWavelengths, size_t numValues, double* attenuation, bool interpolateKnifeEdgeLoss = false);
 
 protected:
     AnnotationManager* annotations;
 
     using VehicleObstacles = std::list<MobileHostObstacle*>;
     VehicleObstacles vehicleObstacles;
+    std::unordered_multimap<const cComponent*, MobileHostObstacle*> vehicleObstaclesByMobility; /**< to find the obstacles whose footprint changes when a mobility module emits a signal */
     AnnotationManager::Group* vehicleAnnotationGroup;
     void drawVehicleObstacles(const simtime_t& t) const;
+
+    /**
+     * (Re-)build vehicleGrid from the positions of all vehicles at time t, unless it is still valid for queries at time t.
+     */
+    void updateVehicleGrid(simtime_t t) const;
+
+    /**
+     * Collect (into candidates, in order of vehicleObstacles) all vehicles which might be on the line of sight from sender to receiver at time t.
+     */
+    void findGridCandidates(const Coord& senderPos, const Coord& receiverPos, simtime_t t) const;
+
+    /**
+     * Uniform grid of vehicle bounding boxes (as checked by MobileHostObstacle::maybeInBounds).
+     *
+     * Rebuilt lazily whenever vehicles have been added, removed, or reported a change in their mobility state.
+     * In-between, vehicles only move along their last known direction at their last known speed,
+     * so queries at a different time just inflate the searched cells by the maximum distance any vehicle can have travelled.
+     */
+    struct VehicleGrid {
+        std::vector<MobileHostObstacle*> vehicles; /**< all vehicles, in order of vehicleObstacles */
+        std::vector<size_t> cellStart; /**< per cell (plus one sentinel): index of its first entry in entries */
+        std::vector<size_t> entries; /**< indices into vehicles, ordered by cells */
+        double originX = 0;
+        double originY = 0;
+        double cellSize = 0;
+        size_t numCols = 0;
+        size_t numRows = 0;
+        simtime_t builtAt; /**< time the vehicle positions were taken at */
+        double maxSpeed = 0; /**< maximum speed of all vehicles at builtAt */
+        bool dirty = true;
+    };
+
+    bool useSpatialGrid;
+    double gridCellSize;
+    mutable VehicleGrid vehicleGrid;
+    mutable std::vector<unsigned int> visitStamps; /**< per vehicle: number of the last query which found it */
+    mutable unsigned int currentStamp = 0; /**< number of the current query */
+    mutable std::vector<size_t> candidates; /**< result of the last call to findGridCandidates */
 };
 
 class VEINS_API VehicleObstacleControlAccess {
@@ -29,9 +29,9 @@
 
 #include "veins/modules/phy/Decider80211p.h"
 #include "veins/modules/phy/DeciderResult80211.h"
-#include "veins/modules/messages/Mac80211Pkt_m.h"
+#include "veins/modules/messages/Mac80211Pkt.h"
 #include "veins/base/toolbox/Signal.h"
-#include "veins/modules/messages/AirFrame11p_m.h"
+#include "veins/modules/messages/AirFrame11p.h"
 #include "veins/modules/phy/NistErrorRate.h"
 #include "veins/modules/utility/ConstsPhy.h"
 
@@ -47,7 +47,8 @@ simtime_t Decider80211p::processNewSignal(AirFrame* msg)
     // get the receiving power of the Signal at start-time and center frequency
     Signal& signal = frame->getSignal();
 
-    signalStates[frame] = EXPECT_END;
+    // every receiver works on its own copy of the AirFrame, so the decider state can live in the frame itself
+    frame->setDeciderState(EXPECT_END);
 
     if (signal.smallerAtCenterFrequency(minPowerLevel)) {
 
@@ -75,6 +76,7 @@ simtime_t Decider80211p::processNewSignal(AirFrame* msg)
             if (!currentSignal.first) {
                 // NIC is not yet synced to any frame, so lock and try to decode this frame
                 currentSignal.first = frame;
+                currentSignal.second = EXPECT_END;
                 EV_TRACE << "AirFrame: " << frame->getId() << " with (" << recvPower << " > " << minPowerLevel << ") -> Trying to receive AirFrame." << std::endl;
                 if (notifyRxStart) {
                     phy->sendControlMsgToMac(new cMessage("RxStartStatus", MacToPhyInterface::PHY_RX_START));
@@ -95,13 +97,7 @@ simtime_t Decider80211p::processNewSignal(AirFrame* msg)
 
 int Decider80211p::getSignalState(AirFrame* frame)
 {
-
-    if (signalStates.find(frame) == signalStates.end()) {
-        return NEW;
-    }
-    else {
-        return signalStates[frame];
-    }
+    return check_and_cast<AirFrame11p*>(frame)->getDeciderState();
 }
 
 DeciderResult* Decider80211p::checkIfSignalOk(AirFrame* frame)
@@ -282,7 +278,7 @@ simtime_t Decider80211p::processSignalEnd(AirFrame* msg)
     bool whileSending = false;
 
     // remove this frame from our current signals
-    signalStates.erase(frame);
+    frame->setDeciderState(NEW);
 
     DeciderResult* result;
 
@@ -306,6 +302,7 @@ simtime_t Decider80211p::processSignalEnd(AirFrame* msg)
             // after having tried to decode the frame, the NIC is no more synced to the frame
             // and it is ready for syncing on a new one
             currentSignal.first = 0;
+            currentSignal.second = NEW;
         }
         else {
             // if this is not the frame we are synced on, we cannot receive it
@@ -406,6 +403,7 @@ void Decider80211p::switchToTx()
             currentFrame->setBitError(true);
             // forget about the signal
             currentSignal.first = 0;
+            currentSignal.second = NEW;
         }
         else {
             throw cRuntimeError("Decider80211p: mac layer requested phy to transmit a frame while currently receiving another");
@@ -415,11 +413,26 @@ void Decider80211p::switchToTx()
 
 void Decider80211p::finish()
 {
-    simtime_t totalTime = simTime() - myStartTime;
+    double stopTime = (myStopTime >= 0) ? myStopTime : simTime().dbl();
+    simtime_t totalTime = stopTime - myStartTime;
     phy->recordScalar("busyTime", myBusyTime / totalTime.dbl());
     if (collectCollisionStats) {
         phy->recordScalar("ncollisions", collisions);
     }
 }
 
+void Decider80211p::pauseStatistics()
+{
+    myStopTime = simTime().dbl();
+}
+
+void Decider80211p::continueStatistics(const Decider80211p& previous)
+{
+    ASSERT(previous.myStopTime >= 0);
+    myBusyTime += previous.myBusyTime;
+    // count the time the previous decider was active as if this one had been
+    myStartTime -= previous.myStopTime - previous.myStartTime;
+    collisions += previous.collisions;
+}
+
 Decider80211p::~Decider80211p(){};
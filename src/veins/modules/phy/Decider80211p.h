@@ -103,10 +103,11 @@ protected:
 
     double myBusyTime;
     double myStartTime;
+    /** @brief time statistics collection was paused at (see pauseStatistics), or -1 */
+    double myStopTime;
 
     std::string myPath;
     Decider80211pToPhy80211pInterface* phy11p;
-    std::map<AirFrame*, int> signalStates;
 
     /** @brief enable/disable statistics collection for collisions
      *
@@ -161,6 +162,7 @@ public:
         , centerFrequency(centerFrequency)
         , myBusyTime(0)
         , myStartTime(simTime().dbl())
+        , myStopTime(-1)
         , collectCollisionStats(collectCollisionStatistics)
         , collisions(0)
         , notifyRxStart(false)
@@ -199,6 +201,16 @@ public:
      */
     void finish() override;
 
+    /**
+     * @brief stop collecting statistics, e.g., while the phy layer is parked for re-use (see RecyclableModule)
+     */
+    void pauseStatistics();
+
+    /**
+     * @brief continue the statistics of a paused decider this one replaces, so finish() records them for both
+     */
+    void continueStatistics(const Decider80211p& previous);
+
     /**
      * @brief Notifies the decider that phy layer is starting a transmission.
      *
@@ -37,6 +37,7 @@
 #include "veins/veins.h"
 
 #include "veins/base/phyLayer/Decider.h"
+#include "veins/base/utils/ObjectPool.h"
 
 namespace veins {
 
@@ -44,10 +45,12 @@ namespace veins {
  * @brief Defines an extended DeciderResult for the 80211 protocol
  * which stores the bit-rate of the transmission.
  *
+ * One result is created per received frame, so instances are pooled.
+ *
  * @ingroup decider
  * @ingroup ieee80211
  */
-class VEINS_API DeciderResult80211 : public DeciderResult {
+class VEINS_API DeciderResult80211 : public DeciderResult, public Pooled<DeciderResult80211> {
 protected:
     /** @brief Stores the bit-rate of the transmission of the packet */
     double bitrate;
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "veins/base/phyLayer/BasePhyLayer.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/base/toolbox/Spectrum.h"
 #include "veins/modules/mac/ieee80211p/Mac80211pToPhy11pInterface.h"
 #include "veins/modules/phy/Decider80211p.h"
@@ -44,9 +45,16 @@ namespace veins {
  * @see PhyLayer80211p
  * @see Decider80211p
  */
-class VEINS_API PhyLayer80211p : public BasePhyLayer, public Mac80211pToPhy11pInterface, public Decider80211pToPhy80211pInterface {
+class VEINS_API PhyLayer80211p : public BasePhyLayer, public Mac80211pToPhy11pInterface, public Decider80211pToPhy80211pInterface, public RecyclableModule {
 public:
     void initialize(int stage) override;
+
+    void prepareForRecycling() override;
+    void reinitialize(int stage) override;
+    int numReinitStages() const override
+    {
+        return numInitStages();
+    }
     /**
      * @brief Set the carrier sense threshold
      * @param ccaThreshold_dBm the cca threshold in dBm
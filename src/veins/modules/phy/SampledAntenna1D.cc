@@ -24,10 +24,14 @@
 #include "veins/modules/phy/SampledAntenna1D.h"
 #include "veins/base/utils/FWMath.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace veins;
 
-SampledAntenna1D::SampledAntenna1D(std::vector<double>& values, std::string offsetType, std::vector<double>& offsetParams, std::string rotationType, std::vector<double>& rotationParams, cRNG* rng)
+SampledAntenna1D::SampledAntenna1D(std::vector<double>& values, std::string offsetType, std::vector<double>& offsetParams, std::string rotationType, std::vector<double>& rotationParams, cRNG* rng, double tableResolution)
     : antennaGains(values.size() + 1)
+    , gainTableStep(0)
 {
     distance = (2 * M_PI) / values.size();
 
@@ -83,6 +87,19 @@ SampledAntenna1D::SampledAntenna1D(std::vector<double>& values, std::string offs
 
     // assign the value of 0 degrees to 360 degrees as well to assure correct interpolation (size allocated already before)
     antennaGains[values.size()] = antennaGains[0];
+
+    // precompute gains for equidistant angles (with the rotation baked in), if requested
+    if (tableResolution < 0) {
+        throw cRuntimeError("SampledAntenna1D::SampledAntenna1D(): The resolution of the gain table must not be negative.");
+    }
+    if (tableResolution > 0) {
+        size_t tableSize = std::max<size_t>(1, std::ceil(360 / tableResolution));
+        gainTableStep = (2 * M_PI) / tableSize;
+        gainTable.resize(tableSize);
+        for (size_t i = 0; i < tableSize; i++) {
+            gainTable[i] = interpolateGain(i * gainTableStep - rotation);
+        }
+    }
 }
 
 SampledAntenna1D::~SampledAntenna1D()
@@ -93,12 +110,29 @@ double SampledAntenna1D::getGain(Coord ownPos, Coord ownOrient, Coord otherPos)
 {
     // get the line of sight vector
     Coord los = otherPos - ownPos;
+
+    if (!gainTable.empty()) {
+        // bearing relative to the orientation from a single atan2 of cross and dot product
+        double cross = ownOrient.x * los.y - ownOrient.y * los.x;
+        double dot = ownOrient.x * los.x + ownOrient.y * los.y;
+        double angle = (cross == 0 && dot == 0) ? atan2(los.y, los.x) : atan2(cross, dot);
+
+        long index = std::lround(angle / gainTableStep) % static_cast<long>(gainTable.size());
+        if (index < 0) index += gainTable.size();
+        return gainTable[index];
+    }
+
     // calculate angle using atan2
     double angle = atan2(los.y, los.x) - atan2(ownOrient.y, ownOrient.x);
 
     // apply possible rotation
     angle -= rotation;
 
+    return interpolateGain(angle);
+}
+
+double SampledAntenna1D::interpolateGain(double angle) const
+{
     // make sure angle is within [0, 2*M_PI)
     angle = fmod(angle, 2 * M_PI);
     if (angle < 0) angle += 2 * M_PI;
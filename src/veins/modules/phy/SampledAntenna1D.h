@@ -36,6 +36,8 @@ namespace veins {
  * As the power is assumed to be relative to an isotropic radiator, the values have to be given in dBi.
  * The values are stored in a mapping automatically supporting linear interpolation between samples.
  * Optional randomness in terms of sample offsets and antenna rotation is supported.
+ * Optionally, the gain can be looked up in a table precomputed for equidistant azimuth angles of the given resolution (in degrees),
+ * which trades exact interpolation for fewer trigonometric and logarithmic operations per call.
  *
  * * An example antenna.xml for this Antenna can be the following:
  * @verbatim
@@ -55,6 +57,9 @@ namespace veins {
 
             <!-- Options for random rotation of the antennas are the same, but mean doesn't have to be 0. -->
             <parameter name="random-rotation" type="string" value="uniform -1 1"/>
+
+            <!-- Optionally, precompute gains for every 0.5 degrees and look them up instead of interpolating. -->
+            <!-- <parameter name="gain-table-resolution" type="double" value="0.5"/> -->
         </Antenna>
     </root>
    @endverbatim
@@ -77,8 +82,9 @@ public:
      * @param rotationType      - name of random distribution to use for the random rotation of the whole antenna
      * @param rotationParams    - contains the parameters for the rotation random distribution
      * @param rng               - pointer to the random number generator to use
+     * @param tableResolution   - azimuth resolution (in degrees) of the precomputed gain table, 0 to always interpolate exactly
      */
-    SampledAntenna1D(std::vector<double>& values, std::string offsetType, std::vector<double>& offsetParams, std::string rotationType, std::vector<double>& rotationParams, cRNG* rng);
+    SampledAntenna1D(std::vector<double>& values, std::string offsetType, std::vector<double>& offsetParams, std::string rotationType, std::vector<double>& rotationParams, cRNG* rng, double tableResolution = 0);
 
     /**
      * @brief Destructor of the sampled antenna.
@@ -95,12 +101,18 @@ public:
      * @param otherPos      - coordinates of the other antenna which this antenna is currently communicating with
      * @return Returns the gain this antenna achieves depending on the computed direction.
      * If the angle is within two samples, linear interpolation is applied.
+     * If a gain table is used, the gain of the nearest table entry is returned instead.
      */
     double getGain(Coord ownPos, Coord ownOrient, Coord otherPos) override;
 
     double getLastAngle() override;
 
 private:
+    /**
+     * @brief Interpolates the gain (in mW) at an angle (in rad) relative to the unrotated samples.
+     */
+    double interpolateGain(double angle) const;
+
     /**
      * @brief Used to store the antenna's samples.
      */
@@ -114,6 +126,16 @@ private:
     double rotation;
 
     double lastAngle;
+
+    /**
+     * @brief Precomputed gains (in mW, rotation already applied) for equidistant angles, empty if not used.
+     */
+    std::vector<double> gainTable;
+
+    /**
+     * @brief Angle (in rad) between two entries of the gain table.
+     */
+    double gainTableStep;
 };
 
 } // namespace veins
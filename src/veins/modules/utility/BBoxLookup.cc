@@ -21,35 +21,16 @@
 //
 
 #include <cmath>
+#include <limits>
 
 #include "veins/modules/utility/BBoxLookup.h"
 
-namespace {
-
-using Point = veins::BBoxLookup::Point;
-using Box = veins::BBoxLookup::Box;
-
-/**
- * Helper structure representing a wireless ray from a sender to a receiver.
- *
- * Contains pre-computed values to speed up calls to intersect with the same ray but different boxes.
- */
-struct Ray {
-    Point origin;
-    Point destination;
-    Point direction;
-    Point invDirection;
-    struct {
-        size_t x;
-        size_t y;
-    } sign;
-    double length;
-};
+namespace veins {
 
 /**
  * Return a Ray struct for fast intersection tests from sender to receiver.
  */
-Ray makeRay(const Point& sender, const Point& receiver)
+BBoxLookup::Ray BBoxLookup::makeRay(const Point& sender, const Point& receiver)
 {
     const double dir_x = receiver.x - sender.x;
     const double dir_y = receiver.y - sender.y;
@@ -65,13 +46,14 @@ Ray makeRay(const Point& sender, const Point& receiver)
     ray.sign.y = ray.invDirection.y < 0;
     return ray;
 }
+
 /**
  * Return whether ray intersects with box.
  *
  * Based on:
  * Amy Williams, Steve Barrus, R. Keith Morley & Peter Shirley (2005) An Efficient and Robust Ray-Box Intersection Algorithm, Journal of Graphics Tools, 10:1, 49-54, DOI: 10.1080/2151237X.2005.10129188
  */
-bool intersects(const Ray& ray, const Box& box)
+bool BBoxLookup::intersects(const Ray& ray, const Box& box)
 {
     const double x[2]{box.p1.x, box.p2.x};
     const double y[2]{box.p1.y, box.p2.y};
@@ -86,10 +68,6 @@ bool intersects(const Ray& ray, const Box& box)
     return (tmin < ray.length) && (tmax > 0);
 }
 
-} // anonymous namespace
-
-namespace veins {
-
 BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BBoxLookup::Box(Obstacle*)> makeBBox, double scenarioX, double scenarioY, int cellSize)
     : bboxes()
     , obstacleLookup()
@@ -107,9 +85,11 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
     const size_t numCells = numCols * numRows;
     std::vector<std::vector<BBoxLookup::Box>> protoCells(numCells);
     std::vector<std::vector<Obstacle*>> protoLookup(numCells);
+    std::vector<std::vector<size_t>> protoIds(numCells);
     // fill protoCells with boundingBoxes
     size_t numEntries = 0;
-    for (const auto obstaclePtr : obstacles) {
+    for (size_t obstacleId = 0; obstacleId < obstacles.size(); ++obstacleId) {
+        const auto obstaclePtr = obstacles[obstacleId];
         auto bbox = makeBBox(obstaclePtr);
         const size_t fromCol = std::min(size_t(std::max(0, int(bbox.p1.x / cellSize))), numCols - 1);
         const size_t toCol = std::min(size_t(std::max(0, int(bbox.p2.x / cellSize))), numCols - 1);
@@ -124,6 +104,7 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
                 const size_t cellIndex = col + row * numCols;
                 protoCells[cellIndex].push_back(bbox);
                 protoLookup[cellIndex].push_back(obstaclePtr);
+                protoIds[cellIndex].push_back(obstacleId);
                 ++numEntries;
                 ASSERT(protoCells[cellIndex].size() == protoLookup[cellIndex].size());
             }
@@ -133,6 +114,7 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
     // phase 2: derive read-only data structure with fast lookup
     bboxes.reserve(numEntries);
     obstacleLookup.reserve(numEntries);
+    obstacleIds.reserve(numEntries);
     bboxCells.reserve(numCells);
     size_t index = 0;
     for (size_t row = 0; row < numRows; ++row) {
@@ -140,12 +122,14 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
             const size_t cellIndex = col + row * numCols;
             auto& currentCell = protoCells.at(cellIndex);
             auto& currentLookup = protoLookup.at(cellIndex);
+            auto& currentIds = protoIds.at(cellIndex);
             ASSERT(currentCell.size() == currentLookup.size());
             const size_t count = currentCell.size();
             // copy over bboxes and obstacle lookups (in strict order)
             for (size_t entryIndex = 0; entryIndex < count; ++entryIndex) {
                 bboxes.push_back(currentCell.at(entryIndex));
                 obstacleLookup.push_back(currentLookup.at(entryIndex));
+                obstacleIds.push_back(currentIds.at(entryIndex));
             }
             // create lookup table for this cell
             bboxCells.push_back({index, count});
@@ -156,6 +140,8 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
     }
     ASSERT(bboxes.size() == numEntries);
     ASSERT(bboxes.size() == obstacleLookup.size());
+    ASSERT(bboxes.size() == obstacleIds.size());
+    numObstacles = obstacles.size();
 }
 
 std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver) const
@@ -200,4 +186,83 @@ std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver)
     return overlappingObstacles;
 }
 
+void BBoxLookup::traverse(Point sender, Point receiver, const std::function<bool(Obstacle*)>& visit) const
+{
+    if (bboxCells.empty()) return;
+
+    // per thread: number of the last traversal which visited each obstacle, and number of the current traversal
+    // (stamps left over from other instances are always smaller than the current one, so they can safely be reused)
+    static thread_local std::vector<unsigned int> visitStamps;
+    static thread_local unsigned int currentStamp = 0;
+
+    // start a new traversal, resetting all stamps when the counter wraps around
+    if (visitStamps.size() < numObstacles) visitStamps.resize(numObstacles, 0);
+    if (++currentStamp == 0) {
+        std::fill(visitStamps.begin(), visitStamps.end(), 0);
+        currentStamp = 1;
+    }
+
+    const Box bbox{
+        {std::min(sender.x, receiver.x), std::min(sender.y, receiver.y)},
+        {std::max(sender.x, receiver.x), std::max(sender.y, receiver.y)},
+    };
+    // precompute transmission ray properties
+    const Ray ray = makeRay(sender, receiver);
+
+    // walk along the cells crossed by the line segment (in unbounded cell coordinates), based on:
+    // John Amanatides & Andrew Woo (1987) A Fast Voxel Traversal Algorithm for Ray Tracing, Eurographics '87, 3-10
+    const double dx = receiver.x - sender.x;
+    const double dy = receiver.y - sender.y;
+    long col = static_cast<long>(std::floor(sender.x / cellSize));
+    long row = static_cast<long>(std::floor(sender.y / cellSize));
+    const long lastCol = static_cast<long>(std::floor(receiver.x / cellSize));
+    const long lastRow = static_cast<long>(std::floor(receiver.y / cellSize));
+    const long stepCol = (dx > 0) ? 1 : -1;
+    const long stepRow = (dy > 0) ? 1 : -1;
+    // parameter t (in [0, 1] along the segment) at which the next cell border is crossed, and t needed to cross a whole cell
+    const double inf = std::numeric_limits<double>::infinity();
+    double tMaxCol = (dx != 0) ? ((col + (stepCol > 0 ? 1 : 0)) * double(cellSize) - sender.x) / dx : inf;
+    double tMaxRow = (dy != 0) ? ((row + (stepRow > 0 ? 1 : 0)) * double(cellSize) - sender.y) / dy : inf;
+    const double tDeltaCol = (dx != 0) ? cellSize / std::abs(dx) : inf;
+    const double tDeltaRow = (dy != 0) ? cellSize / std::abs(dy) : inf;
+    // number of cells crossed, guards against rounding errors in the t values
+    const long numSteps = std::abs(lastCol - col) + std::abs(lastRow - row);
+
+    size_t previousCellIndex = bboxCells.size();
+    for (long step = 0; step <= numSteps; ++step) {
+        // obstacles outside of the grid are stored in its border cells
+        const size_t clampedCol = std::min(size_t(std::max(0L, col)), numCols - 1);
+        const size_t clampedRow = std::min(size_t(std::max(0L, row)), numRows - 1);
+        const size_t cellIndex = clampedCol + clampedRow * numCols;
+
+        if (cellIndex != previousCellIndex) {
+            previousCellIndex = cellIndex;
+            const BBoxCell& cell = bboxCells[cellIndex];
+            for (size_t bboxIndex = cell.index; bboxIndex < cell.index + cell.count; ++bboxIndex) {
+                const size_t obstacleId = obstacleIds[bboxIndex];
+                if (visitStamps[obstacleId] == currentStamp) continue;
+                const Box& current = bboxes[bboxIndex];
+                // check for overlap with bbox (fast rejection)
+                if (current.p2.x < bbox.p1.x) continue;
+                if (current.p1.x > bbox.p2.x) continue;
+                if (current.p2.y < bbox.p1.y) continue;
+                if (current.p1.y > bbox.p2.y) continue;
+                if (!intersects(ray, current)) continue;
+                visitStamps[obstacleId] = currentStamp;
+                if (!visit(obstacleLookup[bboxIndex])) return;
+            }
+        }
+
+        // advance to the next cell crossed by the segment (never overshooting the last cell in either direction)
+        if (row == lastRow || (col != lastCol && tMaxCol < tMaxRow)) {
+            col += stepCol;
+            tMaxCol += tDeltaCol;
+        }
+        else {
+            row += stepRow;
+            tMaxRow += tDeltaRow;
+        }
+    }
+}
+
 } // namespace veins
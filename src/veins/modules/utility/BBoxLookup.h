@@ -56,6 +56,22 @@ public:
         Point p1;
         Point p2;
     };
+    /**
+     * Wireless ray from a sender to a receiver.
+     *
+     * Contains pre-computed values to speed up calls to intersect with the same ray but different boxes.
+     */
+    struct Ray {
+        Point origin;
+        Point destination;
+        Point direction;
+        Point invDirection;
+        struct {
+            size_t x;
+            size_t y;
+        } sign;
+        double length;
+    };
     struct BBoxCell {
         size_t index; /**< index of the first element of this cell in bboxes */
         size_t count; /**< number of elements in this cell; index + number = index of last element */
@@ -64,6 +80,16 @@ public:
     BBoxLookup() = default;
     BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BBoxLookup::Box(Obstacle*)> makeBBox, double scenarioX, double scenarioY, int cellSize = 250);
 
+    /**
+     * Return a Ray struct for fast intersection tests from sender to receiver.
+     */
+    static Ray makeRay(const Point& sender, const Point& receiver);
+
+    /**
+     * Return whether ray intersects with box.
+     */
+    static bool intersects(const Ray& ray, const Box& box);
+
     /**
      * Return all obstacles which have their bounding box touched by the transmission from sender to receiver.
      *
@@ -71,10 +97,24 @@ public:
      */
     std::vector<Obstacle*> findOverlapping(Point sender, Point receiver) const;
 
+    /**
+     * Call visit for every obstacle which has its bounding box touched by the transmission from sender to receiver.
+     *
+     * Only the grid cells crossed by the line segment from sender to receiver are searched (in the order they are crossed), and every obstacle is visited at most once.
+     * The traversal stops early if visit returns false.
+     * Like findOverlapping, false positives are possible.
+     *
+     * Not reentrant: visit must not start another traversal on the same thread.
+     * Concurrent traversals from different threads are fine (as long as the instance is not modified).
+     */
+    void traverse(Point sender, Point receiver, const std::function<bool(Obstacle*)>& visit) const;
+
 private:
     // NOTE: obstacles may occur multiple times in bboxes/obstacleLookup (if they are in multiple cells)
     std::vector<Box> bboxes; /**< ALL bboxes in one chunck of contiguos memory, ordered by cells */
     std::vector<Obstacle*> obstacleLookup; /**< bboxes[i] belongs to instance in obstacleLookup[i] */
+    std::vector<size_t> obstacleIds; /**< bboxes[i] belongs to the obstacleIds[i]-th obstacle passed to the constructor */
+    size_t numObstacles = 0; /**< number of obstacles passed to the constructor */
     std::vector<BBoxCell> bboxCells; /**< flattened matrix of X * Y BBoxCell instances */
     int cellSize = 0;
     size_t numCols = 0; /**< X BBoxCell instances in a row */
@@ -0,0 +1,258 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <algorithm>
+
+#include "veins/modules/utility/BBoxTree.h"
+
+namespace {
+
+using Box = veins::BBoxLookup::Box;
+
+Box merge(const Box& a, const Box& b)
+{
+    return {{std::min(a.p1.x, b.p1.x), std::min(a.p1.y, b.p1.y)}, {std::max(a.p2.x, b.p2.x), std::max(a.p2.y, b.p2.y)}};
+}
+
+/**
+ * Return half the perimeter of box, used as the cost of a node (smaller boxes are less likely to be touched by a query).
+ */
+double cost(const Box& box)
+{
+    return (box.p2.x - box.p1.x) + (box.p2.y - box.p1.y);
+}
+
+} // anonymous namespace
+
+namespace veins {
+
+constexpr int BBoxTree::nil;
+
+BBoxTree::BBoxTree(const std::vector<Obstacle*>& obstacles, std::function<Box(Obstacle*)> makeBBox)
+{
+    if (obstacles.empty()) return;
+    std::vector<std::pair<Obstacle*, Box>> items;
+    items.reserve(obstacles.size());
+    for (const auto obstaclePtr : obstacles) {
+        items.emplace_back(obstaclePtr, makeBBox(obstaclePtr));
+    }
+    nodes.reserve(2 * items.size() - 1);
+    leaves.reserve(items.size());
+    root = build(items, 0, items.size(), nil);
+}
+
+int BBoxTree::build(std::vector<std::pair<Obstacle*, Box>>& items, size_t from, size_t to, int parent)
+{
+    ASSERT(from < to);
+    const int index = allocateNode();
+    nodes[index].parent = parent;
+
+    if (to - from == 1) {
+        nodes[index].bbox = items[from].second;
+        nodes[index].obstacle = items[from].first;
+        nodes[index].left = nil;
+        nodes[index].right = nil;
+        leaves[items[from].first] = index;
+        return index;
+    }
+
+    // split at the median of box centers along the longer axis of their bounds
+    Box centers{{items[from].second.p1.x + items[from].second.p2.x, items[from].second.p1.y + items[from].second.p2.y}, {0, 0}};
+    centers.p2 = centers.p1;
+    for (size_t i = from + 1; i < to; ++i) {
+        const Point center{items[i].second.p1.x + items[i].second.p2.x, items[i].second.p1.y + items[i].second.p2.y};
+        centers = merge(centers, {center, center});
+    }
+    const bool splitX = (centers.p2.x - centers.p1.x) >= (centers.p2.y - centers.p1.y);
+    const size_t mid = from + (to - from) / 2;
+    std::nth_element(items.begin() + from, items.begin() + mid, items.begin() + to, [splitX](const std::pair<Obstacle*, Box>& a, const std::pair<Obstacle*, Box>& b) {
+        return splitX ? (a.second.p1.x + a.second.p2.x < b.second.p1.x + b.second.p2.x) : (a.second.p1.y + a.second.p2.y < b.second.p1.y + b.second.p2.y);
+    });
+
+    // note: recursion may reallocate nodes, so do not hold references across calls
+    const int left = build(items, from, mid, index);
+    const int right = build(items, mid, to, index);
+    nodes[index].obstacle = nullptr;
+    nodes[index].left = left;
+    nodes[index].right = right;
+    nodes[index].bbox = merge(nodes[left].bbox, nodes[right].bbox);
+    return index;
+}
+
+void BBoxTree::insert(Obstacle* obstacle, const Box& bbox)
+{
+    ASSERT(leaves.find(obstacle) == leaves.end());
+    const int leaf = allocateNode();
+    nodes[leaf] = {bbox, obstacle, nil, nil, nil};
+    leaves[obstacle] = leaf;
+
+    if (root == nil) {
+        root = leaf;
+        return;
+    }
+
+    // descend to the sibling whose enclosing boxes grow the least (cf. Box2D's b2DynamicTree)
+    int sibling = root;
+    while (nodes[sibling].left != nil) {
+        const Node& node = nodes[sibling];
+        const double combinedCost = cost(merge(node.bbox, bbox));
+        // cost of pairing the new leaf with this node, and cost added to all ancestors when descending further
+        const double pairCost = 2 * combinedCost;
+        const double inheritanceCost = 2 * (combinedCost - cost(node.bbox));
+        auto descendCost = [&](int child) {
+            const Box merged = merge(nodes[child].bbox, bbox);
+            if (nodes[child].left == nil) return cost(merged) + inheritanceCost;
+            return cost(merged) - cost(nodes[child].bbox) + inheritanceCost;
+        };
+        const double leftCost = descendCost(node.left);
+        const double rightCost = descendCost(node.right);
+        if (pairCost < leftCost && pairCost < rightCost) break;
+        sibling = (leftCost < rightCost) ? node.left : node.right;
+    }
+
+    // replace sibling by a new parent of sibling and leaf
+    const int oldParent = nodes[sibling].parent;
+    const int newParent = allocateNode();
+    nodes[newParent] = {merge(nodes[sibling].bbox, bbox), nullptr, oldParent, sibling, leaf};
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+    if (oldParent == nil) {
+        root = newParent;
+    }
+    else if (nodes[oldParent].left == sibling) {
+        nodes[oldParent].left = newParent;
+    }
+    else {
+        nodes[oldParent].right = newParent;
+    }
+    refitAncestors(newParent);
+}
+
+void BBoxTree::erase(Obstacle* obstacle)
+{
+    auto it = leaves.find(obstacle);
+    if (it == leaves.end()) return;
+    const int leaf = it->second;
+    leaves.erase(it);
+
+    if (leaf == root) {
+        freeNode(leaf);
+        root = nil;
+        return;
+    }
+
+    // replace parent by sibling of leaf
+    const int parent = nodes[leaf].parent;
+    const int grandParent = nodes[parent].parent;
+    const int sibling = (nodes[parent].left == leaf) ? nodes[parent].right : nodes[parent].left;
+    nodes[sibling].parent = grandParent;
+    if (grandParent == nil) {
+        root = sibling;
+    }
+    else {
+        if (nodes[grandParent].left == parent) {
+            nodes[grandParent].left = sibling;
+        }
+        else {
+            nodes[grandParent].right = sibling;
+        }
+        refitAncestors(grandParent);
+    }
+    freeNode(parent);
+    freeNode(leaf);
+}
+
+size_t BBoxTree::size() const
+{
+    return leaves.size();
+}
+
+std::vector<Obstacle*> BBoxTree::findOverlapping(Point sender, Point receiver) const
+{
+    std::vector<Obstacle*> overlappingObstacles;
+    traverse(sender, receiver, [&overlappingObstacles](Obstacle* o) {
+        overlappingObstacles.push_back(o);
+        return true;
+    });
+    return overlappingObstacles;
+}
+
+void BBoxTree::traverse(Point sender, Point receiver, const std::function<bool(Obstacle*)>& visit) const
+{
+    if (root == nil) return;
+
+    const Box bbox{
+        {std::min(sender.x, receiver.x), std::min(sender.y, receiver.y)},
+        {std::max(sender.x, receiver.x), std::max(sender.y, receiver.y)},
+    };
+    // precompute transmission ray properties
+    const BBoxLookup::Ray ray = BBoxLookup::makeRay(sender, receiver);
+
+    // depth-first search, reusing the stack of previous queries on this thread
+    static thread_local std::vector<int> stack;
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        // check for overlap with bbox (fast rejection)
+        if (node.bbox.p2.x < bbox.p1.x) continue;
+        if (node.bbox.p1.x > bbox.p2.x) continue;
+        if (node.bbox.p2.y < bbox.p1.y) continue;
+        if (node.bbox.p1.y > bbox.p2.y) continue;
+        if (!BBoxLookup::intersects(ray, node.bbox)) continue;
+        if (node.left == nil) {
+            if (!visit(node.obstacle)) return;
+            continue;
+        }
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+}
+
+int BBoxTree::allocateNode()
+{
+    if (!freeNodes.empty()) {
+        const int index = freeNodes.back();
+        freeNodes.pop_back();
+        return index;
+    }
+    nodes.emplace_back();
+    return static_cast<int>(nodes.size() - 1);
+}
+
+void BBoxTree::freeNode(int index)
+{
+    nodes[index].obstacle = nullptr;
+    freeNodes.push_back(index);
+}
+
+void BBoxTree::refitAncestors(int index)
+{
+    for (; index != nil; index = nodes[index].parent) {
+        nodes[index].bbox = merge(nodes[nodes[index].left].bbox, nodes[nodes[index].right].bbox);
+    }
+}
+
+} // namespace veins
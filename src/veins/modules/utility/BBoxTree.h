@@ -0,0 +1,109 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/modules/utility/BBoxLookup.h"
+
+namespace veins {
+
+class Obstacle;
+
+/**
+ * Dynamic bounding volume hierarchy to find obstacles (geometric shapes) touched by a transmission.
+ *
+ * Offers the same queries as BBoxLookup, but does not depend on a fixed grid size and supports inserting and erasing single obstacles in O(log N) (for a reasonably balanced tree) instead of requiring a full rebuild.
+ * The tree is built top-down when constructed from a set of obstacles (splitting at the median along the longer axis);
+ * obstacles inserted later are placed where they least increase the perimeter of the enclosing boxes.
+ *
+ * Only considers a 2-dimensional plane (x and y coordinates).
+ * Obstacle instances are stored as pointers, so the lifetime of the obstacle instances is not managed by this class.
+ *
+ * @see BBoxLookup
+ */
+class VEINS_API BBoxTree {
+public:
+    using Point = BBoxLookup::Point;
+    using Box = BBoxLookup::Box;
+
+    BBoxTree() = default;
+    BBoxTree(const std::vector<Obstacle*>& obstacles, std::function<Box(Obstacle*)> makeBBox);
+
+    /**
+     * Add an obstacle with the given bounding box.
+     */
+    void insert(Obstacle* obstacle, const Box& bbox);
+
+    /**
+     * Remove an obstacle, if present.
+     */
+    void erase(Obstacle* obstacle);
+
+    size_t size() const;
+
+    /**
+     * Return all obstacles which have their bounding box touched by the transmission from sender to receiver.
+     *
+     * The obstacles itself may not actually overlap with transmission (false positives are possible).
+     */
+    std::vector<Obstacle*> findOverlapping(Point sender, Point receiver) const;
+
+    /**
+     * Call visit for every obstacle which has its bounding box touched by the transmission from sender to receiver.
+     *
+     * Every obstacle is visited exactly once; the traversal stops early if visit returns false.
+     *
+     * Not reentrant: visit must not start another traversal on the same thread.
+     * Concurrent traversals from different threads are fine (as long as the tree is not modified).
+     */
+    void traverse(Point sender, Point receiver, const std::function<bool(Obstacle*)>& visit) const;
+
+private:
+    static constexpr int nil = -1;
+
+    struct Node {
+        Box bbox;
+        Obstacle* obstacle; /**< only set for leaves */
+        int parent;
+        int left; /**< nil for leaves */
+        int right; /**< nil for leaves */
+    };
+
+    int allocateNode();
+    void freeNode(int index);
+    int build(std::vector<std::pair<Obstacle*, Box>>& items, size_t from, size_t to, int parent);
+    void refitAncestors(int index);
+
+    std::vector<Node> nodes; /**< all nodes in one chunk of contiguous memory, linked by index */
+    std::vector<int> freeNodes; /**< indices of unused entries in nodes */
+    std::unordered_map<Obstacle*, int> leaves; /**< index of the leaf node for every obstacle */
+    int root = nil;
+};
+
+} // namespace veins
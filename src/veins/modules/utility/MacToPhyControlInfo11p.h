@@ -26,6 +26,7 @@
 
 #include "veins/modules/utility/ConstsPhy.h"
 #include "veins/modules/utility/Consts80211p.h"
+#include "veins/base/utils/ObjectPool.h"
 
 namespace veins {
 
@@ -36,7 +37,7 @@ namespace veins {
  * @ingroup phyLayer
  * @ingroup macLayer
  */
-struct VEINS_API MacToPhyControlInfo11p : public cObject {
+struct VEINS_API MacToPhyControlInfo11p : public cObject, public Pooled<MacToPhyControlInfo11p> {
     Channel channelNr; ///< Channel number/index used to select frequency.
     MCS mcs; ///< The modulation and coding scheme to employ for the associated frame.
     double txPower_mW; ///< Transmission power in milliwatts.
@@ -0,0 +1,110 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/modules/utility/ThreadPool.h"
+
+namespace veins {
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isShuttingDown = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& job)
+{
+    if (count == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = &job;
+        jobSize = count;
+        nextIndex = 0;
+        firstError = nullptr;
+        busyWorkers = workers.size();
+        ++generation;
+    }
+    jobAvailable.notify_all();
+
+    // help out, then wait for all workers to finish
+    runJob();
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobDone.wait(lock, [this]() { return busyWorkers == 0; });
+        this->job = nullptr;
+        error = firstError;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void ThreadPool::work()
+{
+    unsigned long lastGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [&]() { return isShuttingDown || (generation != lastGeneration); });
+            if (isShuttingDown) return;
+            lastGeneration = generation;
+        }
+
+        runJob();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyWorkers > 0) continue;
+        }
+        jobDone.notify_one();
+    }
+}
+
+void ThreadPool::runJob()
+{
+    // hand out iterations one by one, as their cost can vary a lot
+    for (size_t i = nextIndex++; i < jobSize; i = nextIndex++) {
+        try {
+            (*job)(i);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+}
+
+} // namespace veins
@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Fixed set of worker threads for running independent, CPU-bound jobs in parallel.
+ *
+ * Work is submitted as a loop over indices (see parallelFor), which blocks until all iterations are done.
+ * The calling thread takes part in the work, so a pool of N threads uses N + 1 cores.
+ *
+ * Jobs must not call into the simulation kernel (e.g., no logging, no signals, no scheduling of events).
+ */
+class VEINS_API ThreadPool {
+public:
+    /**
+     * Start numThreads worker threads.
+     */
+    explicit ThreadPool(size_t numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Call job(i) for every i in [0, count), distributed across all threads, and wait until all calls have returned.
+     *
+     * If any call throws, the first exception is rethrown here (after all other calls have returned).
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+    size_t getNumThreads() const
+    {
+        return workers.size();
+    }
+
+private:
+    void work();
+    void runJob();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobAvailable; /**< signalled when a new job starts (or the pool shuts down) */
+    std::condition_variable jobDone; /**< signalled when the last worker has finished the current job */
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobSize = 0;
+    std::atomic<size_t> nextIndex{0}; /**< next iteration of the current job to be handed out */
+    unsigned long generation = 0; /**< number of the current job, so workers can tell a new job from a spurious wakeup */
+    size_t busyWorkers = 0;
+    std::exception_ptr firstError;
+    bool isShuttingDown = false;
+};
+
+} // namespace veins
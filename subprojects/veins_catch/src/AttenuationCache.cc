@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/AttenuationCache.h"
+
+using veins::AttenuationCache;
+using veins::Coord;
+
+SCENARIO("Caching obstacle attenuation", "[obstacles]")
+{
+    GIVEN("A cache with room for two entries and exact positions")
+    {
+        AttenuationCache cache(2);
+        double factor = 0;
+
+        THEN("Links are found in both directions")
+        {
+            cache.insert(Coord(0, 0), Coord(100, 0), 0.5);
+            REQUIRE(cache.find(Coord(0, 0), Coord(100, 0), factor));
+            REQUIRE(factor == 0.5);
+            REQUIRE(cache.find(Coord(100, 0), Coord(0, 0), factor));
+            REQUIRE(factor == 0.5);
+            REQUIRE_FALSE(cache.find(Coord(0, 0.1), Coord(100, 0), factor));
+            REQUIRE(cache.getNumHits() == 2);
+            REQUIRE(cache.getNumMisses() == 1);
+        }
+
+        THEN("The least recently used entry is evicted")
+        {
+            cache.insert(Coord(0, 0), Coord(1, 0), 0.1);
+            cache.insert(Coord(0, 0), Coord(2, 0), 0.2);
+            REQUIRE(cache.find(Coord(0, 0), Coord(1, 0), factor));
+            cache.insert(Coord(0, 0), Coord(3, 0), 0.3);
+            REQUIRE(cache.size() == 2);
+            REQUIRE(cache.find(Coord(0, 0), Coord(1, 0), factor));
+            REQUIRE_FALSE(cache.find(Coord(0, 0), Coord(2, 0), factor));
+            REQUIRE(cache.find(Coord(0, 0), Coord(3, 0), factor));
+            REQUIRE(factor == 0.3);
+        }
+    }
+
+    GIVEN("A cache quantizing positions to 10 m")
+    {
+        AttenuationCache cache(100, 10);
+        double factor = 0;
+        cache.insert(Coord(1, 2), Coord(98, 51), 0.25);
+
+        THEN("Nearby positions share an entry")
+        {
+            REQUIRE(cache.find(Coord(-3, 4), Coord(102, 48), factor));
+            REQUIRE(factor == 0.25);
+            REQUIRE(cache.find(Coord(104, 47), Coord(0, 0), factor));
+        }
+
+        THEN("Positions in other grid cells do not")
+        {
+            REQUIRE_FALSE(cache.find(Coord(6, 2), Coord(98, 51), factor));
+        }
+    }
+
+    GIVEN("A cache of size zero")
+    {
+        AttenuationCache cache(0);
+        double factor = 0;
+        cache.insert(Coord(0, 0), Coord(1, 0), 0.1);
+
+        THEN("Nothing is cached")
+        {
+            REQUIRE(cache.size() == 0);
+            REQUIRE_FALSE(cache.find(Coord(0, 0), Coord(1, 0), factor));
+        }
+    }
+}
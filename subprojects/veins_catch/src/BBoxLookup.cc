@@ -0,0 +1,97 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <algorithm>
+#include <random>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/BBoxLookup.h"
+#include "veins/modules/obstacle/Obstacle.h"
+
+using veins::BBoxLookup;
+using veins::Coord;
+using veins::Obstacle;
+
+namespace {
+
+std::vector<Obstacle*> sorted(std::vector<Obstacle*> obstacles)
+{
+    std::sort(obstacles.begin(), obstacles.end());
+    obstacles.erase(std::unique(obstacles.begin(), obstacles.end()), obstacles.end());
+    return obstacles;
+}
+
+} // namespace
+
+SCENARIO("Traversing a BBoxLookup along a ray", "[obstacles]")
+{
+    GIVEN("Randomly placed obstacles in a 1000 m x 800 m playground")
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> pos(-50, 1050);
+        std::uniform_real_distribution<double> size(1, 120);
+
+        std::vector<std::unique_ptr<Obstacle>> obstacleOwner;
+        std::vector<Obstacle*> obstacles;
+        for (int i = 0; i < 500; ++i) {
+            double x = pos(rng);
+            double y = pos(rng) * 0.8;
+            double w = size(rng);
+            double h = size(rng);
+            obstacleOwner.emplace_back(new Obstacle(std::to_string(i), "building", 9, 0.4));
+            obstacleOwner.back()->setShape({Coord(x, y), Coord(x + w, y), Coord(x + w, y + h), Coord(x, y + h)});
+            obstacles.push_back(obstacleOwner.back().get());
+        }
+        auto bboxFunction = [](Obstacle* o) { return BBoxLookup::Box{{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}}; };
+        BBoxLookup lookup(obstacles, bboxFunction, 1000, 800, 100);
+
+        THEN("Traversal finds the same obstacles as searching the bounding rectangle, each only once")
+        {
+            std::uniform_real_distribution<double> playgroundPos(0, 1000);
+            for (int i = 0; i < 1000; ++i) {
+                BBoxLookup::Point sender{playgroundPos(rng), playgroundPos(rng) * 0.8};
+                BBoxLookup::Point receiver{playgroundPos(rng), playgroundPos(rng) * 0.8};
+                if (i % 10 == 0) receiver.x = sender.x; // axis-aligned rays
+                if (i % 10 == 1) receiver.y = sender.y;
+                std::vector<Obstacle*> visited;
+                lookup.traverse(sender, receiver, [&visited](Obstacle* o) {
+                    visited.push_back(o);
+                    return true;
+                });
+                auto expected = sorted(lookup.findOverlapping(sender, receiver));
+                REQUIRE(sorted(visited).size() == visited.size());
+                REQUIRE(sorted(visited) == expected);
+            }
+        }
+
+        THEN("Traversal stops once the visitor returns false")
+        {
+            size_t numVisited = 0;
+            lookup.traverse({0, 0}, {1000, 800}, [&numVisited](Obstacle* o) {
+                return ++numVisited < 3;
+            });
+            REQUIRE(numVisited == 3);
+        }
+    }
+}
@@ -0,0 +1,183 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/BBoxTree.h"
+#include "veins/modules/obstacle/Obstacle.h"
+
+using veins::BBoxLookup;
+using veins::BBoxTree;
+using veins::Coord;
+using veins::Obstacle;
+
+namespace {
+
+BBoxLookup::Box obstacleBBox(Obstacle* o)
+{
+    return {{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}};
+}
+
+/**
+ * Square buildings in a regular grid of blocks, as a synthetic city.
+ */
+std::vector<std::unique_ptr<Obstacle>> makeCity(size_t blocksPerSide, double blockSize, double buildingSize)
+{
+    std::vector<std::unique_ptr<Obstacle>> city;
+    for (size_t row = 0; row < blocksPerSide; ++row) {
+        for (size_t col = 0; col < blocksPerSide; ++col) {
+            double x = col * blockSize;
+            double y = row * blockSize;
+            city.emplace_back(new Obstacle(std::to_string(city.size()), "building", 9, 0.4));
+            city.back()->setShape({Coord(x, y), Coord(x + buildingSize, y), Coord(x + buildingSize, y + buildingSize), Coord(x, y + buildingSize)});
+        }
+    }
+    return city;
+}
+
+std::vector<Obstacle*> pointers(const std::vector<std::unique_ptr<Obstacle>>& obstacles)
+{
+    std::vector<Obstacle*> result;
+    for (auto& o : obstacles) result.push_back(o.get());
+    return result;
+}
+
+std::vector<Obstacle*> bruteForce(const std::vector<Obstacle*>& obstacles, BBoxLookup::Point sender, BBoxLookup::Point receiver)
+{
+    const auto ray = BBoxLookup::makeRay(sender, receiver);
+    std::vector<Obstacle*> result;
+    for (auto o : obstacles) {
+        if (BBoxLookup::intersects(ray, obstacleBBox(o))) result.push_back(o);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<Obstacle*> sorted(std::vector<Obstacle*> obstacles)
+{
+    std::sort(obstacles.begin(), obstacles.end());
+    return obstacles;
+}
+
+} // namespace
+
+SCENARIO("Finding obstacles with a BBoxTree", "[obstacles]")
+{
+    GIVEN("A tree built from a synthetic city")
+    {
+        auto city = makeCity(20, 50, 30);
+        auto obstacles = pointers(city);
+        BBoxTree tree(obstacles, obstacleBBox);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> pos(-10, 1010);
+
+        THEN("It finds exactly the obstacles whose bounding box is hit by a ray")
+        {
+            REQUIRE(tree.size() == obstacles.size());
+            for (int i = 0; i < 500; ++i) {
+                BBoxLookup::Point sender{pos(rng), pos(rng)};
+                BBoxLookup::Point receiver{pos(rng), pos(rng)};
+                REQUIRE(sorted(tree.findOverlapping(sender, receiver)) == bruteForce(obstacles, sender, receiver));
+            }
+        }
+
+        THEN("It stays correct when obstacles are erased and inserted")
+        {
+            std::shuffle(obstacles.begin(), obstacles.end(), rng);
+            std::vector<Obstacle*> erased(obstacles.begin(), obstacles.begin() + 150);
+            obstacles.erase(obstacles.begin(), obstacles.begin() + 150);
+            for (auto o : erased) tree.erase(o);
+
+            auto extra = makeCity(10, 97, 20);
+            for (auto& o : extra) {
+                tree.insert(o.get(), obstacleBBox(o.get()));
+                obstacles.push_back(o.get());
+            }
+
+            REQUIRE(tree.size() == obstacles.size());
+            for (int i = 0; i < 500; ++i) {
+                BBoxLookup::Point sender{pos(rng), pos(rng)};
+                BBoxLookup::Point receiver{pos(rng), pos(rng)};
+                REQUIRE(sorted(tree.findOverlapping(sender, receiver)) == bruteForce(obstacles, sender, receiver));
+            }
+
+            for (auto o : obstacles) tree.erase(o);
+            REQUIRE(tree.size() == 0);
+            REQUIRE(tree.findOverlapping({0, 0}, {1000, 1000}).empty());
+        }
+    }
+}
+
+SCENARIO("Benchmarking obstacle lookup in a large synthetic city", "[.][benchmark]")
+{
+    // 200 x 200 blocks of 50 m, i.e., 40000 buildings in a 10 km x 10 km city
+    auto city = makeCity(200, 50, 30);
+    auto obstacles = pointers(city);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pos(0, 10000);
+    std::uniform_real_distribution<double> offset(-500, 500);
+    std::vector<std::pair<BBoxLookup::Point, BBoxLookup::Point>> links;
+    for (int i = 0; i < 10000; ++i) {
+        BBoxLookup::Point sender{pos(rng), pos(rng)};
+        links.push_back({sender, {sender.x + offset(rng), sender.y + offset(rng)}});
+    }
+
+    BBoxLookup grid(obstacles, obstacleBBox, 10000, 10000, 250);
+    BBoxTree tree(obstacles, obstacleBBox);
+    size_t numFound = 0;
+    auto count = [&numFound](Obstacle*) {
+        ++numFound;
+        return true;
+    };
+
+    BENCHMARK("build grid")
+    {
+        grid = BBoxLookup(obstacles, obstacleBBox, 10000, 10000, 250);
+    }
+    BENCHMARK("build tree")
+    {
+        tree = BBoxTree(obstacles, obstacleBBox);
+    }
+    BENCHMARK("query grid (bounding rectangle)")
+    {
+        for (auto& link : links) numFound += grid.findOverlapping(link.first, link.second).size();
+    }
+    BENCHMARK("query grid (ray traversal)")
+    {
+        for (auto& link : links) grid.traverse(link.first, link.second, count);
+    }
+    BENCHMARK("query tree")
+    {
+        for (auto& link : links) tree.traverse(link.first, link.second, count);
+    }
+    BENCHMARK("erase and re-insert 100 obstacles in tree")
+    {
+        for (size_t i = 0; i < 100; ++i) tree.erase(obstacles[i * 397]);
+        for (size_t i = 0; i < 100; ++i) tree.insert(obstacles[i * 397], obstacleBBox(obstacles[i * 397]));
+    }
+    REQUIRE(numFound > 0);
+}
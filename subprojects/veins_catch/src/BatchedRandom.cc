@@ -0,0 +1,197 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/utils/BatchedRandom.h"
+
+using veins::BatchedRandom;
+
+namespace {
+
+/**
+ * RNG that does not need a configuration to be initialized.
+ */
+class TestRNG : public cRNG {
+public:
+    TestRNG(uint32_t seed)
+        : engine(seed)
+    {
+    }
+
+    void initialize(int, int, int, int, int, cConfiguration*) override
+    {
+    }
+
+    void selfTest() override
+    {
+    }
+
+    uint32_t intRand() override
+    {
+        return engine();
+    }
+
+    uint32_t intRandMax() override
+    {
+        return std::mt19937::max();
+    }
+
+    uint32_t intRand(uint32_t n) override
+    {
+        return std::uniform_int_distribution<uint32_t>(0, n - 1)(engine);
+    }
+
+    double doubleRand() override
+    {
+        return engine() * (1.0 / 4294967296.0);
+    }
+
+    double doubleRandNonz() override
+    {
+        return (engine() + 1.0) * (1.0 / 4294967297.0);
+    }
+
+    double doubleRandIncl1() override
+    {
+        return engine() * (1.0 / 4294967295.0);
+    }
+
+private:
+    std::mt19937 engine;
+};
+
+/**
+ * Kolmogorov-Smirnov statistic of two samples (which are sorted in the process).
+ */
+double ksStatistic(std::vector<double>& a, std::vector<double>& b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    double d = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.size() && j < b.size()) {
+        double x = std::min(a[i], b[j]);
+        while (i < a.size() && a[i] <= x) ++i;
+        while (j < b.size() && b[j] <= x) ++j;
+        d = std::max(d, std::abs(static_cast<double>(i) / a.size() - static_cast<double>(j) / b.size()));
+    }
+    return d;
+}
+
+} // namespace
+
+SCENARIO("BatchedRandom draws from the reference distributions", "[BatchedRandom]")
+{
+    const size_t n = 20000;
+    // KS critical value for two samples of size n at a significance level of 0.001
+    const double ksCritical = 1.95 * std::sqrt(2.0 / n);
+
+    TestRNG batchRng(1);
+    TestRNG referenceRng(2);
+    BatchedRandom random(&batchRng, 1000);
+
+    GIVEN("Gamma variates drawn one by one and into arrays")
+    {
+        const double theta = 2;
+
+        THEN("They follow the reference distribution for any shape")
+        {
+            for (double alpha : {0.75, 1.5, 4.0}) {
+                INFO("shape " << alpha);
+                std::vector<double> reference(n);
+                for (auto& value : reference) {
+                    value = omnetpp::gamma_d(&referenceRng, alpha, theta);
+                }
+
+                std::vector<double> batched(n);
+                for (auto& value : batched) {
+                    value = random.gamma_d(alpha, theta);
+                }
+                REQUIRE(ksStatistic(batched, reference) < ksCritical);
+
+                // crosses batch boundaries
+                random.gamma_d(alpha, theta, batched.data(), 333);
+                random.gamma_d(alpha, theta, batched.data() + 333, n - 333);
+                REQUIRE(ksStatistic(batched, reference) < ksCritical);
+            }
+        }
+    }
+
+    GIVEN("Normal variates")
+    {
+        std::vector<double> reference(n);
+        std::vector<double> batched(n);
+        for (size_t i = 0; i < n; ++i) {
+            reference[i] = omnetpp::normal(&referenceRng, 3, 2);
+            batched[i] = random.normal(3, 2);
+        }
+
+        THEN("They follow the reference distribution")
+        {
+            REQUIRE(ksStatistic(batched, reference) < ksCritical);
+        }
+    }
+
+    GIVEN("Exponential variates")
+    {
+        std::vector<double> reference(n);
+        std::vector<double> batched(n);
+        for (size_t i = 0; i < n; ++i) {
+            reference[i] = omnetpp::exponential(&referenceRng, 3);
+            batched[i] = random.exponential(3);
+        }
+
+        THEN("They follow the reference distribution")
+        {
+            REQUIRE(ksStatistic(batched, reference) < ksCritical);
+        }
+    }
+}
+
+SCENARIO("BatchedRandom is reproducible", "[BatchedRandom]")
+{
+    GIVEN("Two instances drawing from identically seeded RNGs")
+    {
+        TestRNG rng1(5);
+        TestRNG rng2(5);
+        BatchedRandom random1(&rng1, 16);
+        BatchedRandom random2(&rng2, 16);
+
+        THEN("Interleaved draws from different distributions match")
+        {
+            for (int i = 0; i < 100; ++i) {
+                REQUIRE(random1.gamma_d(0.75, 1) == random2.gamma_d(0.75, 1));
+                REQUIRE(random1.gamma_d(1.5, 2) == random2.gamma_d(1.5, 2));
+                REQUIRE(random1.uniform(0, 1) == random2.uniform(0, 1));
+            }
+        }
+    }
+}
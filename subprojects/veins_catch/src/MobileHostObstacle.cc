@@ -0,0 +1,173 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <set>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/MobileHostObstacle.h"
+
+using veins::Coord;
+using veins::MobileHostObstacle;
+
+namespace {
+
+// reference implementation: footprint as a polygon, intersections collected in a multiset
+
+MobileHostObstacle::Coords referenceShape(Coord p, double a, double l, double o, double w)
+{
+    w = w / 2;
+    MobileHostObstacle::Coords shape;
+    shape.push_back(p + Coord(-(l - o), -w).rotatedYaw(-a));
+    shape.push_back(p + Coord(+o, -w).rotatedYaw(-a));
+    shape.push_back(p + Coord(+o, +w).rotatedYaw(-a));
+    shape.push_back(p + Coord(-(l - o), +w).rotatedYaw(-a));
+    return shape;
+}
+
+bool referenceIsPointInObstacle(Coord point, const MobileHostObstacle::Coords& shape)
+{
+    bool isInside = false;
+    auto i = shape.begin();
+    auto j = (shape.rbegin() + 1).base();
+    for (; i != shape.end(); j = i++) {
+        bool inYRange = ((point.y >= i->y) && (point.y < j->y)) || ((point.y >= j->y) && (point.y < i->y));
+        if (!inYRange) continue;
+        bool intersects = point.x < (i->x + ((point.y - i->y) * (j->x - i->x) / (j->y - i->y)));
+        if (!intersects) continue;
+        isInside = !isInside;
+    }
+    return isInside;
+}
+
+double referenceSegmentsIntersectAt(Coord p1From, Coord p1To, Coord p2From, Coord p2To)
+{
+    Coord p1Vec = p1To - p1From;
+    Coord p2Vec = p2To - p2From;
+    Coord p1p2 = p1From - p2From;
+    double D = (p1Vec.x * p2Vec.y - p1Vec.y * p2Vec.x);
+    double p1Frac = (p2Vec.x * p1p2.y - p2Vec.y * p1p2.x) / D;
+    if (p1Frac < 0 || p1Frac > 1) return -1;
+    double p2Frac = (p1Vec.x * p1p2.y - p1Vec.y * p1p2.x) / D;
+    if (p2Frac < 0 || p2Frac > 1) return -1;
+    return p1Frac;
+}
+
+double referenceIntersectionPoint(const Coord& senderPos, const Coord& receiverPos, const MobileHostObstacle::Coords& shape)
+{
+    if (referenceIsPointInObstacle(senderPos, shape)) return 0;
+    std::multiset<double> intersectAt;
+    auto i = shape.begin();
+    auto j = (shape.rbegin() + 1).base();
+    for (; i != shape.end(); j = i++) {
+        double inter = referenceSegmentsIntersectAt(senderPos, receiverPos, *i, *j);
+        if (inter != -1) intersectAt.insert(inter);
+    }
+    if (intersectAt.empty()) {
+        if (referenceIsPointInObstacle(receiverPos, shape)) return senderPos.distance(receiverPos);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return (*intersectAt.begin() * senderPos.distance(receiverPos));
+}
+
+} // namespace
+
+SCENARIO("Intersecting a beam with a vehicle footprint", "[vehicleObstacles]")
+{
+    GIVEN("A 4m x 2m car at (10, 10) facing east, positioned at its front bumper")
+    {
+        auto r = MobileHostObstacle::Rectangle::fromHost(Coord(10, 10, 1.5), 0, 4, 0, 2);
+
+        THEN("Its corners are those of the original polygon")
+        {
+            auto corners = r.getCorners();
+            REQUIRE(corners[0].x == Approx(6));
+            REQUIRE(corners[0].y == Approx(9));
+            REQUIRE(corners[2].x == Approx(10));
+            REQUIRE(corners[2].y == Approx(11));
+            REQUIRE(corners[2].z == Approx(1.5));
+        }
+
+        THEN("A beam passing through it is obstructed at the first edge it crosses")
+        {
+            REQUIRE(r.getIntersectionPoint(Coord(8, 0), Coord(8, 20)) == Approx(9));
+            REQUIRE(r.getIntersectionPoint(Coord(20, 10), Coord(0, 10)) == Approx(10));
+        }
+
+        THEN("A beam starting inside is obstructed right away")
+        {
+            REQUIRE(r.getIntersectionPoint(Coord(8, 10), Coord(8, 20)) == 0);
+        }
+
+        THEN("A beam passing by is not obstructed")
+        {
+            REQUIRE(std::isnan(r.getIntersectionPoint(Coord(0, 12), Coord(20, 12))));
+            REQUIRE(std::isnan(r.getIntersectionPoint(Coord(0, 10), Coord(5, 10))));
+            REQUIRE(std::isnan(r.getIntersectionPoint(Coord(12, 0), Coord(12, 20))));
+        }
+    }
+
+    GIVEN("Randomly placed and rotated vehicles and beams")
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> pos(-20, 20);
+        std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+        std::uniform_real_distribution<double> size(1, 10);
+
+        THEN("Footprints and intersection points match the polygon-based implementation")
+        {
+            size_t hits = 0;
+            for (size_t k = 0; k < 10000; ++k) {
+                Coord p(pos(rng), pos(rng), 1.5);
+                double a = angle(rng);
+                double l = size(rng);
+                double o = size(rng) - 5;
+                double w = size(rng) / 2;
+                auto r = MobileHostObstacle::Rectangle::fromHost(p, a, l, o, w);
+                auto shape = referenceShape(p, a, l, o, w);
+
+                auto corners = r.getCorners();
+                for (size_t c = 0; c < 4; ++c) {
+                    REQUIRE(corners[c].x == Approx(shape[c].x).margin(1e-9));
+                    REQUIRE(corners[c].y == Approx(shape[c].y).margin(1e-9));
+                }
+
+                Coord sender(pos(rng), pos(rng), 2);
+                Coord receiver(pos(rng), pos(rng), 1);
+                double expected = referenceIntersectionPoint(sender, receiver, shape);
+                double actual = r.getIntersectionPoint(sender, receiver);
+                if (std::isnan(expected)) {
+                    REQUIRE(std::isnan(actual));
+                }
+                else {
+                    REQUIRE(actual == Approx(expected).margin(1e-9));
+                    ++hits;
+                }
+            }
+            REQUIRE(hits > 500);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <algorithm>
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/utils/ObjectPool.h"
+
+using veins::ObjectPool;
+using veins::Pooled;
+
+namespace {
+
+struct PooledObject : public Pooled<PooledObject> {
+    virtual ~PooledObject() = default;
+    double values[4];
+};
+
+struct LargerPooledObject : public PooledObject {
+    double moreValues[4];
+};
+
+} // namespace
+
+SCENARIO("ObjectPool reuses released blocks", "[ObjectPool]")
+{
+    GIVEN("A pool for objects of 32 bytes")
+    {
+        ObjectPool pool("test", 32, 2);
+
+        WHEN("A block is released and another one is allocated")
+        {
+            void* first = pool.allocate(32);
+            pool.release(first, 32);
+            void* second = pool.allocate(32);
+
+            THEN("The released block is handed out again")
+            {
+                REQUIRE(second == first);
+                REQUIRE(pool.getNumAllocations() == 2);
+                REQUIRE(pool.getNumHits() == 1);
+                REQUIRE(pool.getHitRate() == Approx(0.5));
+                REQUIRE(pool.getNumFree() == 0);
+            }
+            pool.release(second, 32);
+        }
+
+        WHEN("More blocks are released than the pool keeps")
+        {
+            void* blocks[] = {pool.allocate(32), pool.allocate(32), pool.allocate(32)};
+            for (auto block : blocks) {
+                pool.release(block, 32);
+            }
+
+            THEN("Only the maximum number of blocks is kept")
+            {
+                REQUIRE(pool.getNumFree() == 2);
+            }
+        }
+
+        WHEN("A block of a different size is allocated and released")
+        {
+            void* block = pool.allocate(64);
+            pool.release(block, 64);
+
+            THEN("The pool is bypassed")
+            {
+                REQUIRE(pool.getNumAllocations() == 0);
+                REQUIRE(pool.getNumFree() == 0);
+            }
+        }
+
+        WHEN("Its statistics are reset")
+        {
+            void* block = pool.allocate(32);
+            pool.release(block, 32);
+            pool.resetStatistics();
+
+            THEN("Counting starts from zero, but released blocks are kept")
+            {
+                REQUIRE(pool.getNumAllocations() == 0);
+                REQUIRE(pool.getNumHits() == 0);
+                REQUIRE(pool.getNumFree() == 1);
+            }
+        }
+
+        THEN("The pool is registered")
+        {
+            auto& pools = ObjectPool::getPools();
+            REQUIRE(std::find(pools.begin(), pools.end(), &pool) != pools.end());
+        }
+    }
+}
+
+SCENARIO("Pooled classes recycle their instances", "[ObjectPool]")
+{
+    ObjectPool& pool = PooledObject::getPool();
+
+    GIVEN("An instance that has been deleted")
+    {
+        PooledObject* first = new PooledObject();
+        delete first;
+        uint64_t hits = pool.getNumHits();
+
+        WHEN("A new instance is created")
+        {
+            PooledObject* second = new PooledObject();
+
+            THEN("It reuses the memory of the deleted one")
+            {
+                REQUIRE(static_cast<void*>(second) == static_cast<void*>(first));
+                REQUIRE(pool.getNumHits() == hits + 1);
+            }
+            delete second;
+        }
+
+        WHEN("An instance of a subclass is created and deleted")
+        {
+            size_t numFree = pool.getNumFree();
+            PooledObject* larger = new LargerPooledObject();
+            delete larger;
+
+            THEN("It does not use the pool")
+            {
+                REQUIRE(pool.getNumHits() == hits);
+                REQUIRE(pool.getNumFree() == numFree);
+            }
+        }
+    }
+}
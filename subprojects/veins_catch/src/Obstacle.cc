@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/Obstacle.h"
+
+using veins::Coord;
+using veins::Obstacle;
+
+SCENARIO("Intersecting a beam with an obstacle", "[obstacles]")
+{
+    GIVEN("A square building from (10, 10) to (20, 20)")
+    {
+        Obstacle o("building#0", "building", 9, 0.4);
+        o.setShape({Coord(10, 10), Coord(20, 10), Coord(20, 20), Coord(10, 20)});
+
+        THEN("A beam passing through it crosses two walls")
+        {
+            auto intersections = o.getIntersections(Coord(0, 15), Coord(40, 15));
+            REQUIRE(intersections.size() == 2);
+            REQUIRE(intersections[0] == Approx(0.25));
+            REQUIRE(intersections[1] == Approx(0.5));
+        }
+
+        THEN("A beam passing by does not cross any wall")
+        {
+            REQUIRE(o.getIntersections(Coord(0, 25), Coord(40, 25)).empty());
+            REQUIRE(o.getIntersections(Coord(0, 15), Coord(5, 15)).empty());
+        }
+
+        THEN("A beam starting inside crosses one wall")
+        {
+            auto intersections = o.getIntersections(Coord(15, 15), Coord(15, 35));
+            REQUIRE(intersections.size() == 1);
+            REQUIRE(intersections[0] == Approx(0.25));
+        }
+
+        THEN("Writing intersections to a buffer yields the same points")
+        {
+            std::vector<double> buffer(o.getNumEdges());
+            REQUIRE(buffer.size() == 4);
+            size_t count = o.getIntersections(Coord(40, 18), Coord(0, 12), buffer.data());
+            buffer.resize(count);
+            REQUIRE(buffer == o.getIntersections(Coord(40, 18), Coord(0, 12)));
+            REQUIRE(count == 2);
+        }
+
+        THEN("Only points inside are contained")
+        {
+            REQUIRE(o.containsPoint(Coord(15, 15)));
+            REQUIRE(o.containsPoint(Coord(10, 10)));
+            REQUIRE_FALSE(o.containsPoint(Coord(20, 20)));
+            REQUIRE_FALSE(o.containsPoint(Coord(5, 15)));
+            REQUIRE_FALSE(o.containsPoint(Coord(15, 25)));
+        }
+    }
+}
@@ -0,0 +1,144 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <cstdio>
+#include <string>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/PolygonFile.h"
+
+using veins::Coord;
+using veins::PolygonFile;
+
+namespace {
+
+std::vector<PolygonFile::Polygon> parse(const std::string& content)
+{
+    return PolygonFile::parse(content.data(), content.data() + content.size());
+}
+
+std::vector<Coord> parseShape(const std::string& shape)
+{
+    std::vector<Coord> result;
+    PolygonFile::parseShape(shape.data(), shape.data() + shape.size(), result);
+    return result;
+}
+
+} // namespace
+
+SCENARIO("Parsing SUMO polygon files", "[obstacles]")
+{
+    GIVEN("A polygon file with comments, other elements, and both quoting styles")
+    {
+        const std::string content = R"(<?xml version="1.0" encoding="UTF-8"?>
+<!-- <poly id="commented" type="building" shape="0,0 1,1 1,0"/> -->
+<additional>
+    <poly id="building#0" type="building" color="#F00" shape="16,0 8,13.8564 -8,13.8564" />
+    <poi id="poi#0" type="tree" x="1" y="2"/>
+    <poly type='building' id='a&amp;b' layer="1.00" shape='0.5,1.5,3 2,1.5,3
+        2,3,3'/>
+    <poly id="park" type="park" fill="1" shape="0,0 10,0 10,10"></poly>
+</additional>
+)";
+
+        THEN("All polygons are found")
+        {
+            auto polygons = parse(content);
+            REQUIRE(polygons.size() == 3);
+            REQUIRE(polygons[0].id == "building#0");
+            REQUIRE(polygons[0].type == "building");
+            REQUIRE(polygons[0].shape.size() == 3);
+            REQUIRE(polygons[0].shape[1] == Coord(8, 13.8564));
+            REQUIRE(polygons[1].id == "a&b");
+            REQUIRE(polygons[1].shape.size() == 3);
+            REQUIRE(polygons[1].shape[0] == Coord(0.5, 1.5));
+            REQUIRE(polygons[1].shape[2] == Coord(2, 3));
+            REQUIRE(polygons[2].type == "park");
+        }
+    }
+
+    GIVEN("Malformed polygon files")
+    {
+        THEN("Parsing fails")
+        {
+            REQUIRE_THROWS(parse("<poly id=\"a\" type=\"b\" shape=\"0,0 1,1\""));
+            REQUIRE_THROWS(parse("<poly id=\"a\" type=\"b\"/>"));
+            REQUIRE_THROWS(parse("<poly id=\"a\" type=\"b\" shape=\"0,0 1\"/>"));
+            REQUIRE_THROWS(parse("<poly id=\"a\" type=\"b\" geo=\"1\" shape=\"0,0 1,1\"/>"));
+            REQUIRE_THROWS(parse("<!-- <poly id=\"a\" type=\"b\" shape=\"0,0 1,1\"/>"));
+        }
+    }
+
+    GIVEN("Shapes")
+    {
+        THEN("Whitespace and z coordinates are tolerated")
+        {
+            REQUIRE(parseShape("").empty());
+            REQUIRE(parseShape("  1,2\t3,4,5 \n").size() == 2);
+            REQUIRE(parseShape("-1e2,2.5")[0] == Coord(-100, 2.5));
+        }
+
+        THEN("Malformed shapes are rejected")
+        {
+            REQUIRE_THROWS(parseShape("1"));
+            REQUIRE_THROWS(parseShape("1,2,3,4"));
+            REQUIRE_THROWS(parseShape("1,2;3,4"));
+            REQUIRE_THROWS(parseShape("1,x"));
+        }
+    }
+}
+
+SCENARIO("Caching parsed polygon files", "[obstacles]")
+{
+    GIVEN("Parsed polygons")
+    {
+        const std::string content = "<poly id=\"a\" type=\"building\" shape=\"0,0 10,0 10,10\"/><poly id=\"b\" type=\"\" shape=\"1,1 2,2\"/>";
+        const uint64_t contentHash = PolygonFile::hash(content.data(), content.data() + content.size());
+        auto polygons = parse(content);
+
+        THEN("They can be saved and loaded again")
+        {
+            const std::string path = "polygonfile-test.bin";
+            PolygonFile::saveCache(path, contentHash, polygons);
+
+            std::vector<PolygonFile::Polygon> loaded;
+            REQUIRE(PolygonFile::loadCache(path, contentHash, loaded));
+            REQUIRE(loaded.size() == 2);
+            REQUIRE(loaded[0].id == "a");
+            REQUIRE(loaded[0].type == "building");
+            REQUIRE(loaded[0].shape.size() == 3);
+            REQUIRE(loaded[0].shape[2] == Coord(10, 10));
+            REQUIRE(loaded[1].id == "b");
+            REQUIRE(loaded[1].type == "");
+            REQUIRE(loaded[1].shape[1] == Coord(2, 2));
+
+            std::vector<PolygonFile::Polygon> notLoaded;
+            REQUIRE_FALSE(PolygonFile::loadCache(path, contentHash + 1, notLoaded));
+            REQUIRE_FALSE(PolygonFile::loadCache("does-not-exist.bin", contentHash, notLoaded));
+            REQUIRE(notLoaded.empty());
+
+            std::remove(path.c_str());
+        }
+    }
+}
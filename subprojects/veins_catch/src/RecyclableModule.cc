@@ -0,0 +1,129 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/modules/RecyclableModule.h"
+
+using veins::RecyclableModule;
+
+namespace {
+
+class FakeModule : public RecyclableModule {
+public:
+    FakeModule(std::string name, int numStages, std::vector<std::string>& log)
+        : name(name)
+        , numStages(numStages)
+        , log(log)
+    {
+    }
+
+    void initialize(int stage)
+    {
+        if (stage == 0) {
+            timerScheduled = true;
+            vehicles++;
+        }
+        initializedStages = stage + 1;
+    }
+
+    void prepareForRecycling() override
+    {
+        log.push_back("prepare " + name);
+        timerScheduled = false;
+        initializedStages = 0;
+    }
+
+    void reinitialize(int stage) override
+    {
+        log.push_back("reinitialize " + name + " " + std::to_string(stage));
+        initialize(stage);
+    }
+
+    int numReinitStages() const override
+    {
+        return numStages;
+    }
+
+    std::string name;
+    int numStages;
+    std::vector<std::string>& log;
+
+    bool timerScheduled = false;
+    int initializedStages = 0;
+    int vehicles = 0; /**< statistics, kept across re-use */
+};
+
+} // namespace
+
+SCENARIO("Recycling modules", "[recycling]")
+{
+    GIVEN("A parent module with two submodules that use different numbers of init stages")
+    {
+        std::vector<std::string> log;
+        FakeModule host("host", 1, log);
+        FakeModule appl("appl", 2, log);
+        FakeModule nic("nic", 3, log);
+        std::vector<RecyclableModule*> modules = {&host, &appl, &nic};
+        for (auto m : {&host, &appl, &nic}) {
+            for (int stage = 0; stage < m->numReinitStages(); stage++) {
+                m->initialize(stage);
+            }
+        }
+
+        WHEN("the modules are prepared for recycling")
+        {
+            RecyclableModule::prepareAll(modules);
+
+            THEN("all modules are prepared, parents first")
+            {
+                REQUIRE(log == std::vector<std::string>({"prepare host", "prepare appl", "prepare nic"}));
+                REQUIRE_FALSE(host.timerScheduled);
+                REQUIRE_FALSE(appl.timerScheduled);
+                REQUIRE_FALSE(nic.timerScheduled);
+            }
+
+            AND_WHEN("the modules are re-initialized")
+            {
+                log.clear();
+                RecyclableModule::reinitializeAll(modules);
+
+                THEN("all modules complete one stage before any module starts the next one")
+                {
+                    REQUIRE(log == std::vector<std::string>({"reinitialize host 0", "reinitialize appl 0", "reinitialize nic 0", "reinitialize appl 1", "reinitialize nic 1", "reinitialize nic 2"}));
+                }
+                THEN("each module is initialized again for all its stages, keeping its statistics")
+                {
+                    REQUIRE(host.initializedStages == 1);
+                    REQUIRE(appl.initializedStages == 2);
+                    REQUIRE(nic.initializedStages == 3);
+                    REQUIRE(nic.timerScheduled);
+                    REQUIRE(nic.vehicles == 2);
+                }
+            }
+        }
+    }
+}
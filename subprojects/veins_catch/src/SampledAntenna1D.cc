@@ -64,5 +64,37 @@ SCENARIO("Using SampledAntenna1D", "[toolbox]")
             double gain = p.getGain(ownPos, ownOrient, otherPos);
             REQUIRE(gain == Approx(res));
         }
+
+        WHEN("a gain table with a resolution of 1 degree is used")
+        {
+            auto t = SampledAntenna1D(values, offsetType, offsetParams, rotationType, rotationParams, rng, 1);
+
+            THEN("gains at whole degrees match the interpolated ones")
+            {
+                for (auto& check : checks) {
+                    auto ownPos = std::get<0>(check);
+                    auto otherPos = std::get<1>(check);
+                    auto ownOrient = std::get<2>(check);
+                    auto res = std::get<3>(check);
+
+                    INFO("sending from " << ownPos << " to " << otherPos << " while looking at " << ownOrient << " should return " << res);
+                    REQUIRE(t.getGain(ownPos, ownOrient, otherPos) == Approx(res));
+                }
+            }
+            THEN("gains in between stay within the gains of the neighboring degrees")
+            {
+                double angle = 10.4 / 180 * M_PI;
+                double gain = t.getGain(Coord(0, 0, 0), Coord(1, 0, 0), Coord(cos(angle), sin(angle), 0));
+                double lower = p.getGain(Coord(0, 0, 0), Coord(1, 0, 0), Coord(cos(10.0 / 180 * M_PI), sin(10.0 / 180 * M_PI), 0));
+                double upper = p.getGain(Coord(0, 0, 0), Coord(1, 0, 0), Coord(cos(11.0 / 180 * M_PI), sin(11.0 / 180 * M_PI), 0));
+                REQUIRE(gain >= Approx(lower));
+                REQUIRE(gain <= Approx(upper));
+            }
+        }
+        THEN("the antenna is not isotropic")
+        {
+            REQUIRE_FALSE(p.isIsotropic());
+            REQUIRE(veins::Antenna().isIsotropic());
+        }
     }
 }
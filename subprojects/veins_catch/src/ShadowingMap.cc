@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <cmath>
+#include <cstdio>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/ShadowingMap.h"
+
+using veins::Coord;
+using veins::ShadowingMap;
+
+SCENARIO("Precomputed shadowing maps", "[obstacles]")
+{
+    GIVEN("A 3 x 2 map with 10 m resolution")
+    {
+        const Coord position(5, 5, 3);
+        ShadowingMap map(position, 10, 3, 2, 42);
+        map.set(0, 0, 0);
+        map.set(1, 0, 10);
+        map.set(2, 0, 20);
+        map.set(0, 1, 10);
+        map.set(1, 1, 20);
+        map.set(2, 1, 30);
+
+        THEN("Attenuation is interpolated between raster points")
+        {
+            double factor = 0;
+            REQUIRE(map.lookup(Coord(10, 0), factor));
+            REQUIRE(factor == Approx(0.1));
+            REQUIRE(map.lookup(Coord(5, 5), factor));
+            REQUIRE(factor == Approx(0.1));
+            REQUIRE(map.lookup(Coord(15, 0), factor));
+            REQUIRE(factor == Approx(std::pow(10, -1.5)));
+        }
+
+        THEN("Positions outside of the raster are not covered")
+        {
+            double factor = 0;
+            REQUIRE_FALSE(map.lookup(Coord(-1, 5), factor));
+            REQUIRE_FALSE(map.lookup(Coord(25, 5), factor));
+            REQUIRE_FALSE(map.lookup(Coord(5, 10.5), factor));
+        }
+
+        THEN("The fixed position is recognized regardless of height")
+        {
+            REQUIRE(map.isAt(Coord(5, 5, 1.5)));
+            REQUIRE_FALSE(map.isAt(Coord(5, 6, 3)));
+        }
+
+        THEN("It can be saved and loaded again")
+        {
+            const std::string path = "shadowingmap-test.bin";
+            map.save(path);
+
+            auto loaded = ShadowingMap::load(path, position, 10, 42);
+            REQUIRE(loaded);
+            REQUIRE(loaded->getNumCols() == 3);
+            REQUIRE(loaded->getNumRows() == 2);
+            REQUIRE(loaded->get(2, 1) == 30);
+            double factor = 0;
+            REQUIRE(loaded->lookup(Coord(15, 0), factor));
+            REQUIRE(factor == Approx(std::pow(10, -1.5)));
+
+            REQUIRE_FALSE(ShadowingMap::load(path, position, 10, 43));
+            REQUIRE_FALSE(ShadowingMap::load(path, position, 5, 42));
+            REQUIRE_FALSE(ShadowingMap::load(path, Coord(5, 5, 0), 10, 42));
+            REQUIRE_FALSE(ShadowingMap::load("does-not-exist.bin", position, 10, 42));
+
+            loaded.reset();
+            std::remove(path.c_str());
+        }
+    }
+}
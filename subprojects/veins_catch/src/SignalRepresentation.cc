@@ -239,6 +239,65 @@ SCENARIO("Signal Constructors and Assignment", "[toolbox]")
     }
 }
 
+SCENARIO("Signal Storage and Move", "[toolbox]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    GIVEN("A short spectrum (1,2,3) and a long spectrum (1,...,40)")
+    {
+        Spectrum shortSpectrum({1, 2, 3});
+        Spectrum::Frequencies longFreqs;
+        for (int i = 1; i <= 40; i++) {
+            longFreqs.push_back(i);
+        }
+        Spectrum longSpectrum(longFreqs);
+
+        WHEN("signals with values (1,2,3) and (1,...,40) are moved")
+        {
+            Signal shortSignal(shortSpectrum, 10, 5);
+            shortSignal.at(0) = 1;
+            shortSignal.at(1) = 2;
+            shortSignal.at(2) = 3;
+            Signal longSignal(longSpectrum);
+            for (size_t i = 0; i < longSignal.getNumValues(); i++) {
+                longSignal.at(i) = i + 1;
+            }
+            const double* longValues = longSignal.getValues();
+
+            Signal movedShort(std::move(shortSignal));
+            Signal movedLong(std::move(longSignal));
+
+            THEN("the values and timing are retained")
+            {
+                REQUIRE(movedShort.getSpectrum() == shortSpectrum);
+                REQUIRE(movedShort.getNumValues() == 3);
+                REQUIRE(movedShort.at(0) == 1);
+                REQUIRE(movedShort.at(2) == 3);
+                REQUIRE(movedShort.getSendingStart() == 10);
+                REQUIRE(movedShort.getDuration() == 5);
+                REQUIRE(movedLong.getNumValues() == 40);
+                REQUIRE(movedLong.at(39) == 40);
+            }
+            THEN("the values of the long signal are not copied")
+            {
+                REQUIRE(movedLong.getValues() == longValues);
+            }
+        }
+        WHEN("a temporary signal is combined with others")
+        {
+            Signal signal(shortSpectrum);
+            signal = 2;
+            Signal result = (signal + signal) * signal + 1;
+            THEN("the result is the same as for named signals")
+            {
+                REQUIRE(result.at(0) == 9);
+                REQUIRE(result.at(1) == 9);
+                REQUIRE(result.at(2) == 9);
+                REQUIRE(signal.at(0) == 2);
+            }
+        }
+    }
+}
+
 SCENARIO("Signal Value Access", "[toolbox]")
 {
     DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
@@ -0,0 +1,75 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/ThreadPool.h"
+
+using veins::ThreadPool;
+
+SCENARIO("Running jobs on a ThreadPool", "[threadPool]")
+{
+    GIVEN("A pool of three worker threads")
+    {
+        ThreadPool pool(3);
+        REQUIRE(pool.getNumThreads() == 3);
+
+        THEN("Every iteration of a job is run exactly once, across many jobs")
+        {
+            for (size_t count : {0, 1, 2, 100, 10000}) {
+                std::vector<int> runs(count, 0);
+                pool.parallelFor(count, [&](size_t i) { ++runs[i]; });
+                REQUIRE(std::count(runs.begin(), runs.end(), 1) == static_cast<long>(count));
+            }
+        }
+
+        THEN("An exception thrown by an iteration is passed on to the caller")
+        {
+            std::vector<int> runs(100, 0);
+            REQUIRE_THROWS_AS(pool.parallelFor(runs.size(), [&](size_t i) {
+                ++runs[i];
+                if (i == 42) throw std::runtime_error("iteration failed");
+            }), std::runtime_error);
+            REQUIRE(std::count(runs.begin(), runs.end(), 1) == 100);
+
+            pool.parallelFor(runs.size(), [&](size_t i) { ++runs[i]; });
+            REQUIRE(std::count(runs.begin(), runs.end(), 2) == 100);
+        }
+    }
+
+    GIVEN("A pool without worker threads")
+    {
+        ThreadPool pool(0);
+
+        THEN("Jobs run on the calling thread")
+        {
+            std::vector<int> runs(10, 0);
+            pool.parallelFor(runs.size(), [&](size_t i) { ++runs[i]; });
+            REQUIRE(std::count(runs.begin(), runs.end(), 1) == 10);
+        }
+    }
+}
@@ -108,4 +108,36 @@ SCENARIO("Using VehicleObstacleControl", "[vehicleObstacles]")
             REQUIRE(r.at(0) == Approx(2 * r_des + r_corr));
         }
     }
+
+    GIVEN("Several vehicles between sender and receiver and a spectrum of multiple frequencies")
+    {
+
+        std::vector<std::pair<double, double>> dz_vec = {{0, 1.5}, {12, 1.6}, {20, 3.2}, {31, 1.4}, {45, 2.1}, {60, 1.5}};
+        Spectrum::Frequencies freqs = {2.4e9, 5.85e9, 5.89e9, 5.9e9, 5.925e9};
+        Signal attenuationPrototype = Signal(Spectrum(freqs));
+
+        auto r = VehicleObstacleControl::getVehicleAttenuationDZ(dz_vec, attenuationPrototype);
+        auto invSqrtWavelengths = VehicleObstacleControl::getInvSqrtWavelengths(attenuationPrototype.getSpectrum());
+        std::vector<double> attenuation(freqs.size(), -1);
+
+        THEN("The array-based kernel matches the Signal-based implementation within 1e-12 dB per obstacle")
+        {
+            VehicleObstacleControl::getVehicleAttenuationDZ(dz_vec, invSqrtWavelengths.data(), attenuation.size(), attenuation.data());
+
+            for (size_t i = 0; i < freqs.size(); i++) {
+                REQUIRE(r.at(i) > 0);
+                REQUIRE(std::abs(attenuation[i] - r.at(i)) <= 1e-12 * (dz_vec.size() - 2));
+            }
+        }
+
+        THEN("The array-based kernel with interpolated knife-edge loss matches the Signal-based implementation within 0.0005 dB per obstacle")
+        {
+            VehicleObstacleControl::getVehicleAttenuationDZ(dz_vec, invSqrtWavelengths.data(), attenuation.size(), attenuation.data(), true);
+
+            for (size_t i = 0; i < freqs.size(); i++) {
+                REQUIRE(r.at(i) > 0);
+                REQUIRE(attenuation[i] == Approx(r.at(i)).margin(0.0005 * (dz_vec.size() - 2)));
+            }
+        }
+    }
 }
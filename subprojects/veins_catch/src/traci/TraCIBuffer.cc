@@ -0,0 +1,133 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <limits>
+#include <list>
+#include <string>
+
+#include "catch2/catch.hpp"
+#include "veins/modules/mobility/traci/TraCIBuffer.h"
+#include "veins/modules/mobility/traci/TraCICoord.h"
+
+using veins::TraCIBuffer;
+using veins::TraCICoord;
+
+SCENARIO("TraCIBuffer encodes values in TraCI byte order", "[traci]")
+{
+    GIVEN("An empty buffer")
+    {
+        TraCIBuffer buf;
+
+        THEN("Integers and doubles are written big endian")
+        {
+            buf << static_cast<uint8_t>(0x01) << static_cast<int32_t>(0x02030405) << static_cast<uint16_t>(0x0607) << 1.0;
+            REQUIRE(buf.str() == std::string("\x01\x02\x03\x04\x05\x06\x07\x3f\xf0\x00\x00\x00\x00\x00\x00", 15));
+        }
+
+        THEN("Strings are written with a length prefix")
+        {
+            buf << std::string("abc") << std::string();
+            REQUIRE(buf.str() == std::string("\x00\x00\x00\x03" "abc" "\x00\x00\x00\x00", 11));
+        }
+
+        THEN("String lists are written with a count prefix")
+        {
+            buf << std::list<std::string>{"a", "bc"};
+            REQUIRE(buf.str() == std::string("\x00\x00\x00\x02\x00\x00\x00\x01" "a" "\x00\x00\x00\x02" "bc", 15));
+        }
+    }
+}
+
+SCENARIO("TraCIBuffer round-trips values", "[traci]")
+{
+    GIVEN("A buffer holding values of all supported types")
+    {
+        const std::string binary("a\0b\xff", 4);
+        const std::string longString(100000, 'x');
+        TraCIBuffer buf;
+        buf.reserve(128);
+        buf << static_cast<int8_t>(-2) << static_cast<uint8_t>(255) << static_cast<int32_t>(-123456789) << static_cast<uint32_t>(4000000000u) << static_cast<int64_t>(-1234567890123ll);
+        buf << -0.5 << std::numeric_limits<double>::infinity() << std::numeric_limits<double>::denorm_min();
+        buf << std::string("vehicle.0") << binary << longString;
+        buf << TraCICoord(12.5, -7.25) << simtime_t(1.5);
+
+        THEN("They are read back unchanged")
+        {
+            TraCIBuffer in(buf.str());
+            REQUIRE(in.read<int8_t>() == -2);
+            REQUIRE(in.read<uint8_t>() == 255);
+            REQUIRE(in.read<int32_t>() == -123456789);
+            REQUIRE(in.read<uint32_t>() == 4000000000u);
+            REQUIRE(in.read<int64_t>() == -1234567890123ll);
+            REQUIRE(in.read<double>() == -0.5);
+            REQUIRE(in.read<double>() == std::numeric_limits<double>::infinity());
+            REQUIRE(in.read<double>() == std::numeric_limits<double>::denorm_min());
+            REQUIRE(in.read<std::string>() == "vehicle.0");
+            REQUIRE(in.read<std::string>() == binary);
+            REQUIRE(in.read<std::string>() == longString);
+            TraCICoord coord = in.read<TraCICoord>();
+            REQUIRE(coord.x == 12.5);
+            REQUIRE(coord.y == -7.25);
+            REQUIRE(in.read<simtime_t>() == simtime_t(1.5));
+            REQUIRE(in.eof());
+        }
+
+        THEN("Strings can be read without copying them")
+        {
+            TraCIBuffer in(buf.str());
+            in.read<int8_t>();
+            in.read<uint8_t>();
+            in.read<int32_t>();
+            in.read<uint32_t>();
+            in.read<int64_t>();
+            in.read<double>();
+            in.read<double>();
+            in.read<double>();
+            TraCIBuffer::StringView id = in.readStringView();
+            REQUIRE(id == "vehicle.0");
+            REQUIRE(id != "vehicle.1");
+            REQUIRE(id != "vehicle.0 ");
+            REQUIRE(in.readStringView().str() == binary);
+            REQUIRE(in.readStringView().size == longString.size());
+
+            TraCIBuffer out;
+            out << id;
+            REQUIRE(TraCIBuffer(out.str()).read<std::string>() == "vehicle.0");
+        }
+    }
+
+    GIVEN("A truncated buffer")
+    {
+        TraCIBuffer buf;
+        buf << std::string("vehicle.0");
+        const std::string truncated = buf.str().substr(0, buf.str().size() - 1);
+
+        THEN("Reading past its end fails")
+        {
+            REQUIRE_THROWS(TraCIBuffer(truncated).read<std::string>());
+            REQUIRE_THROWS(TraCIBuffer(truncated).readStringView());
+            REQUIRE_THROWS(TraCIBuffer(truncated.substr(0, 3)).read<uint32_t>());
+            REQUIRE_THROWS(TraCIBuffer().read<uint8_t>());
+        }
+    }
+}
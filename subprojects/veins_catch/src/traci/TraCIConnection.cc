@@ -0,0 +1,178 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "catch2/catch.hpp"
+#include "testutils/Simulation.h"
+#include "testutils/Component.h"
+#include "veins/modules/mobility/traci/TraCIBuffer.h"
+#include "veins/modules/mobility/traci/TraCIConnection.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+#include "veins/modules/mobility/traci/TraCITrace.h"
+
+using namespace veins;
+using namespace veins::TraCIConstants;
+
+namespace {
+
+std::string makeStatus(uint8_t commandId)
+{
+    return (TraCIBuffer() << static_cast<uint8_t>(1 + 1 + 1 + 4) << commandId << static_cast<uint8_t>(RTYPE_OK) << std::string()).str();
+}
+
+} // namespace
+
+SCENARIO("TraCIConnection rejects commands while a simulation step is pending", "[traci]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    DummyComponent dc(&ds);
+    const std::string fileName = "test_TraCIConnection.trace";
+
+    // the replayed trace stands in for a TraCI server
+    {
+        TraCITraceWriter writer(fileName);
+        writer.write(TraCITrace::SENT, makeTraCICommand(CMD_SIMSTEP2, TraCIBuffer() << simtime_t(1)));
+        writer.write(TraCITrace::RECEIVED, makeStatus(CMD_SIMSTEP2) + (TraCIBuffer() << static_cast<int32_t>(0)).str());
+    }
+    std::unique_ptr<TraCIConnection> connection(TraCIConnection::replay(&dc, fileName));
+
+    GIVEN("A simulation step requested in the background")
+    {
+        connection->startQuery(CMD_SIMSTEP2, TraCIBuffer() << simtime_t(1));
+        REQUIRE(connection->hasPendingQuery());
+
+        THEN("Sending a command fails")
+        {
+            REQUIRE_THROWS_AS(connection->query(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_SPEED << std::string("veh0")), cRuntimeError);
+        }
+
+        THEN("Queueing a command fails")
+        {
+            REQUIRE_THROWS_AS(connection->enqueue(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_SPEED << std::string("veh0"), true), cRuntimeError);
+        }
+
+        THEN("The step can still be finished")
+        {
+            TraCIBuffer buf = connection->finishQuery();
+            REQUIRE(buf.read<int32_t>() == 0);
+            REQUIRE(buf.eof());
+            REQUIRE_FALSE(connection->hasPendingQuery());
+        }
+    }
+
+    connection.reset();
+    std::remove(fileName.c_str());
+}
+
+SCENARIO("TraCIConnection matches queued commands to their responses", "[traci]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    DummyComponent dc(&ds);
+    const std::string fileName = "test_TraCIConnection_queue.trace";
+
+    // the status of the subscription has the id of a response to the set command
+    const TraCIBuffer setCommand = TraCIBuffer() << VAR_SPEED << std::string("veh0") << static_cast<uint8_t>(TYPE_DOUBLE) << 1.0;
+    const TraCIBuffer subscribeCommand = TraCIBuffer() << simtime_t(0) << simtime_t(1) << std::string("veh0") << static_cast<uint8_t>(1) << VAR_SPEED;
+    const std::string subscribeResponse = makeTraCICommand(RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE, TraCIBuffer() << std::string("veh0") << static_cast<uint8_t>(0));
+    {
+        TraCITraceWriter writer(fileName);
+        writer.write(TraCITrace::SENT, makeTraCICommand(CMD_SET_VEHICLE_VARIABLE, setCommand) + makeTraCICommand(CMD_SUBSCRIBE_VEHICLE_VARIABLE, subscribeCommand));
+        writer.write(TraCITrace::RECEIVED, makeStatus(CMD_SET_VEHICLE_VARIABLE) + makeStatus(CMD_SUBSCRIBE_VEHICLE_VARIABLE) + subscribeResponse);
+    }
+    std::unique_ptr<TraCIConnection> connection(TraCIConnection::replay(&dc, fileName));
+
+    GIVEN("A set command queued before a subscription")
+    {
+        std::string setResponse = "not called";
+        std::string subscriptionResponse = "not called";
+        connection->enqueue(CMD_SET_VEHICLE_VARIABLE, setCommand, false, [&setResponse](TraCIBuffer& buf) { setResponse = buf.str(); });
+        connection->enqueue(CMD_SUBSCRIBE_VEHICLE_VARIABLE, subscribeCommand, true, [&subscriptionResponse](TraCIBuffer& buf) { subscriptionResponse = buf.str(); });
+
+        WHEN("The queue is flushed")
+        {
+            connection->flush();
+
+            THEN("Only the subscription receives a response")
+            {
+                REQUIRE(setResponse.empty());
+                REQUIRE(subscriptionResponse == subscribeResponse);
+            }
+        }
+    }
+
+    connection.reset();
+    std::remove(fileName.c_str());
+}
+
+SCENARIO("TraCIConnection replays a recorded trace", "[traci]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    DummyComponent dc(&ds);
+    const std::string fileName = "test_TraCIConnection_replay.trace";
+
+    const TraCIBuffer getSpeed = TraCIBuffer() << VAR_SPEED << std::string("veh0");
+    const std::string speedResponse = makeTraCICommand(RESPONSE_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_SPEED << std::string("veh0") << static_cast<uint8_t>(TYPE_DOUBLE) << 13.9);
+    {
+        TraCITraceWriter writer(fileName);
+        writer.write(TraCITrace::SENT, makeTraCICommand(CMD_GET_VEHICLE_VARIABLE, getSpeed));
+        writer.write(TraCITrace::RECEIVED, makeStatus(CMD_GET_VEHICLE_VARIABLE) + speedResponse);
+    }
+    std::unique_ptr<TraCIConnection> connection(TraCIConnection::replay(&dc, fileName));
+
+    WHEN("The recorded command is sent")
+    {
+        TraCIBuffer buf = connection->query(CMD_GET_VEHICLE_VARIABLE, getSpeed);
+
+        THEN("The recorded response is returned")
+        {
+            REQUIRE(buf.str().substr(buf.str().size() - speedResponse.size()) == speedResponse);
+        }
+
+        THEN("Sending an extra command fails")
+        {
+            REQUIRE_THROWS_AS(connection->query(CMD_GET_VEHICLE_VARIABLE, getSpeed), cRuntimeError);
+        }
+    }
+
+    WHEN("A command with different parameters is sent")
+    {
+        THEN("Replaying fails")
+        {
+            REQUIRE_THROWS_AS(connection->query(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_SPEED << std::string("veh1")), cRuntimeError);
+        }
+    }
+
+    WHEN("A different command is sent")
+    {
+        THEN("Replaying fails")
+        {
+            REQUIRE_THROWS_AS(connection->query(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_SPEED << std::string("veh0") << static_cast<uint8_t>(TYPE_DOUBLE) << 1.0), cRuntimeError);
+        }
+    }
+
+    connection.reset();
+    std::remove(fileName.c_str());
+}
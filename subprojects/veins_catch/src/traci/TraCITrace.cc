@@ -0,0 +1,118 @@
+//
+// Copyright (C) 2020 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "catch2/catch.hpp"
+#include "veins/modules/mobility/traci/TraCIBuffer.h"
+#include "veins/modules/mobility/traci/TraCIConnection.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+#include "veins/modules/mobility/traci/TraCITrace.h"
+
+using veins::TraCIBuffer;
+using veins::TraCITraceReader;
+using veins::TraCITraceWriter;
+using veins::makeTraCICommand;
+namespace TraCITrace = veins::TraCITrace;
+namespace TraCIConstants = veins::TraCIConstants;
+
+SCENARIO("TraCITrace replays recorded messages in order", "[traci]")
+{
+    const std::string fileName = "test_TraCITrace.trace";
+    const std::string version = makeTraCICommand(TraCIConstants::CMD_GETVERSION);
+    const std::string step = makeTraCICommand(TraCIConstants::CMD_SIMSTEP2, TraCIBuffer() << 1.0);
+    const std::string response = std::string("\x07\x02\x00\x00\x00\x00\x00", 7);
+
+    GIVEN("A trace of two requests, one of them a simulation step")
+    {
+        {
+            TraCITraceWriter writer(fileName);
+            writer.write(TraCITrace::SENT, version);
+            writer.write(TraCITrace::RECEIVED, response);
+            writer.write(TraCITrace::SENT, step);
+            writer.write(TraCITrace::RECEIVED, std::string());
+        }
+
+        THEN("Messages are read back in the order they were written")
+        {
+            TraCITraceReader reader(fileName);
+            REQUIRE(reader.read(TraCITrace::SENT) == version);
+            REQUIRE(reader.read(TraCITrace::RECEIVED) == response);
+            REQUIRE(reader.getNumStepsRead() == 0);
+            REQUIRE(reader.read(TraCITrace::SENT) == step);
+            REQUIRE(reader.getNumStepsRead() == 1);
+            REQUIRE(reader.read(TraCITrace::RECEIVED).empty());
+            REQUIRE_THROWS_AS(reader.read(TraCITrace::SENT), std::runtime_error);
+        }
+
+        THEN("The index tells the number and target times of simulation steps")
+        {
+            TraCITraceReader reader(fileName);
+            REQUIRE(reader.getNumSteps() == 1);
+            REQUIRE(reader.getStepTime(0) == 1.0);
+        }
+
+        THEN("Reading can continue at a simulation step")
+        {
+            TraCITraceReader reader(fileName);
+            reader.seekToStep(0);
+            REQUIRE(reader.getNumStepsRead() == 0);
+            REQUIRE(reader.read(TraCITrace::SENT) == step);
+            REQUIRE(reader.getNumStepsRead() == 1);
+            REQUIRE(reader.read(TraCITrace::RECEIVED).empty());
+            REQUIRE_THROWS_AS(reader.seekToStep(1), std::runtime_error);
+        }
+
+        THEN("Reading a message in the wrong direction fails")
+        {
+            TraCITraceReader reader(fileName);
+            REQUIRE_THROWS_AS(reader.read(TraCITrace::RECEIVED), std::runtime_error);
+        }
+
+        THEN("A trace without its index is rejected")
+        {
+            std::string data;
+            {
+                std::ifstream in(fileName, std::ios::binary);
+                data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+            {
+                std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+                out << data.substr(0, data.size() - 1);
+            }
+            REQUIRE_THROWS(TraCITraceReader(fileName));
+        }
+
+        std::remove(fileName.c_str());
+    }
+}
+
+TEST_CASE("TraCITrace finds the first command of a message", "[traci]")
+{
+    REQUIRE(TraCITrace::getFirstCommandId(makeTraCICommand(TraCIConstants::CMD_SIMSTEP2, TraCIBuffer() << 1.0)) == TraCIConstants::CMD_SIMSTEP2);
+    REQUIRE(TraCITrace::getFirstCommandId(makeTraCICommand(TraCIConstants::CMD_GETVERSION, TraCIBuffer() << std::string(300, 'x'))) == TraCIConstants::CMD_GETVERSION);
+    REQUIRE(TraCITrace::getFirstCommandId(std::string()) == 0);
+}
@@ -1103,6 +1103,25 @@ void TraCITestApp::performTest(const simtime_t t)
         }
     }
 
+    //
+    // TraCIScenarioManager (run with penetrationRate 0.5 and unsubscribeUnequippedVehicles, see omnetpp.ini, so flow0.1 is unequipped)
+    //
+
+    if (testNumber == testCounter++) {
+        if (t == 10) {
+            // make the unequipped vehicle behind us collide with us, so it is teleported
+            traciVehicle->setSpeed(0);
+            traci->vehicle("flow0.1").setSpeedMode(0);
+            traci->vehicle("flow0.1").setSpeed(50);
+        }
+        if (t == 20) {
+            assertTrue("(TraCIScenarioManager::unsubscribeUnequippedVehicles) unequipped vehicle was not given a module", mobility->getManager()->getManagedHosts().count("flow0.1") == 0);
+        }
+        if (t == 999) {
+            pass("(TraCIScenarioManager::unsubscribeUnequippedVehicles) teleporting unequipped vehicle did not abort the run");
+        }
+    }
+
     //
     // End
     //
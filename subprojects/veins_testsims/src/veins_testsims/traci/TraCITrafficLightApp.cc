@@ -22,7 +22,7 @@
 
 #include "veins_testsims/traci/TraCITrafficLightApp.h"
 
-#include "veins/modules/messages/DemoSafetyMessage_m.h"
+#include "veins/modules/messages/DemoSafetyMessage.h"
 
 using veins::TraCITrafficLightApp;
 